@@ -40,6 +40,8 @@
 
 /*----- Static function prototypes -----------------------------------*/
 
+static fract32 _inv_samplerate(uint32_t samplerate);
+
 /*----- Extern function implementations ------------------------------*/
 
 void Aleph_init(t_Aleph *const aleph, uint32_t samplerate, char *memory,
@@ -51,8 +53,8 @@ void Aleph_init(t_Aleph *const aleph, uint32_t samplerate, char *memory,
 
     aleph->samplerate = samplerate;
 
-    // aleph->inv_samplerate = 1.0f / samplerate;
-    //
+    aleph->inv_samplerate = _inv_samplerate(samplerate);
+
     // aleph->twopi_inv_samplerate = aleph->inv_samplerate * TWO_PI;
 
     aleph->random = random;
@@ -72,12 +74,16 @@ void Aleph_init(t_Aleph *const aleph, uint32_t samplerate, char *memory,
 
 void Aleph_set_samplerate(t_Aleph *const aleph, uint32_t samplerate) {
     aleph->samplerate = samplerate;
-    // aleph->inv_samplerate = 1.0f / samplerate;
+    aleph->inv_samplerate = _inv_samplerate(samplerate);
     // aleph->twopi_inv_samplerate = aleph->inv_samplerate * TWO_PI;
 }
 
 fract32 Aleph_get_samplerate(t_Aleph *const aleph) { return aleph->samplerate; }
 
+fract32 Aleph_normalise_frequency(t_Aleph *const aleph, fix16 hz) {
+    return fix16_mul_fract_radix(hz, aleph->inv_samplerate, 27);
+}
+
 void Aleph_default_error_callback(t_Aleph *const aleph,
                                   e_Aleph_error_type whichone) {
     // Not sure what this should do if anything
@@ -101,4 +107,9 @@ t_Mempool *Aleph_get_mempool(t_Aleph *const aleph) { return aleph->mempool; }
 
 /*----- Static function implementations ------------------------------*/
 
+// 2^42 / samplerate, fix16 Hz times this in 27 radix is normalised frequency.
+static fract32 _inv_samplerate(uint32_t samplerate) {
+    return (fract32)(((uint64_t)1 << 42) / samplerate);
+}
+
 /*----- End of file --------------------------------------------------*/
@@ -59,10 +59,12 @@ struct t_Aleph {
                          //!< Aleph_set_samplerate().
     uint32_t block_size; //!< The audio block size.
 
+    fract32 inv_samplerate; //!< The inverse of the current sample rate,
+                            //!< 2^42 / samplerate. Used by
+                            //!< Aleph_normalise_frequency().
+
     /// TODO: Calculate fract32 values.
     //
-    /* fract32 inv_samplerate;       //!< The inverse of the current sample
-     * rate. */
     /* fract32 twopi_inv_samplerate; //!<  Two-pi times the inverse of the */
     //!<  current sample rate.
 
@@ -114,6 +116,14 @@ void Aleph_set_samplerate(t_Aleph *const aleph, uint32_t samplerate);
  */
 fract32 Aleph_get_samplerate(t_Aleph *const aleph);
 
+//! Convert a frequency in Hz to a normalised frequency.
+/*!
+ @param hz The frequency in Hz as fix16.
+ @return The frequency as a fraction of the sample rate, FR32_MAX is the
+ sample rate.
+ */
+fract32 Aleph_normalise_frequency(t_Aleph *const aleph, fix16 hz);
+
 //! The default callback function for Aleph errors.
 /*!
  @param error_type The type of the error that has occurred.
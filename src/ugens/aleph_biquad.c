@@ -33,10 +33,16 @@
 
 #include "aleph_biquad.h"
 
+#include "aleph_sine_table.h"
 #include "aleph_utils.h"
 
 /*----- Macros -------------------------------------------------------*/
 
+// Linear estimate of 1/m for m in [0.5, 1), 48/17 - 32/17 * m, 3.29 radix.
+#define RECIP_EST_OFFSET (0x5A5A5A5A)
+#define RECIP_EST_SLOPE (0x3C3C3C3C)
+#define RECIP_ITERATIONS (3)
+
 /*----- Typedefs -----------------------------------------------------*/
 
 /*----- Static variable definitions ----------------------------------*/
@@ -45,6 +51,18 @@
 
 /*----- Static function prototypes -----------------------------------*/
 
+static inline fract32 _sat_8x24(int64_t acc);
+static inline fract32 _mult_8x24(fract32 a, fract32 b);
+static void _section_next_block(t_Aleph_BiquadCoeffs *coeffs, fract32 *x_,
+                                fract32 *x__, fract32 *y_, fract32 *y__,
+                                fract32 *input, fract32 *output, size_t size);
+static void _section_next_block_interp(t_Aleph_BiquadCoeffs *start,
+                                       t_Aleph_BiquadCoeffs *end, fract32 *x_,
+                                       fract32 *x__, fract32 *y_,
+                                       fract32 *y__, fract32 *input,
+                                       fract32 *output, size_t size);
+static fract32 _recip_8x24(fract32 x);
+
 /*----- Extern function implementations ------------------------------*/
 
 void Aleph_Biquad_init(t_Aleph_Biquad *bq) {
@@ -71,6 +89,37 @@ fract32 Aleph_Biquad_next(t_Aleph_Biquad *bq, fract32 x) {
     return ret;
 }
 
+void Aleph_Biquad_next_block(t_Aleph_Biquad *bq, fract32 *input,
+                             fract32 *output, size_t size) {
+    t_Aleph_BiquadCoeffs coeffs;
+
+    coeffs.a1 = bq->a1;
+    coeffs.a2 = bq->a2;
+    coeffs.b0 = bq->b0;
+    coeffs.b1 = bq->b1;
+    coeffs.b2 = bq->b2;
+
+    _section_next_block(&coeffs, &bq->x_, &bq->x__, &bq->y_, &bq->y__, input,
+                        output, size);
+}
+
+void Aleph_Biquad_next_block_interp(t_Aleph_Biquad *bq,
+                                    t_Aleph_BiquadCoeffs *end, fract32 *input,
+                                    fract32 *output, size_t size) {
+    t_Aleph_BiquadCoeffs start;
+
+    start.a1 = bq->a1;
+    start.a2 = bq->a2;
+    start.b0 = bq->b0;
+    start.b1 = bq->b1;
+    start.b2 = bq->b2;
+
+    _section_next_block_interp(&start, end, &bq->x_, &bq->x__, &bq->y_,
+                               &bq->y__, input, output, size);
+
+    Aleph_Biquad_set_coeffs(bq, end);
+}
+
 void Aleph_Biquad_set_coeffs_from_floats(t_Aleph_Biquad *bq, float a1, float a2,
                                          float b0, float b1, float b2) {
     bq->a1 = FLOAT_C8X24(a1);
@@ -99,6 +148,400 @@ void Aleph_Biquad_set_lpf(t_Aleph_Biquad *bq, float freq, float q) {
     bq->b2 = FLOAT_C8X24(b2 / a0);
 }
 
+void Aleph_Biquad_set_coeffs(t_Aleph_Biquad *bq, t_Aleph_BiquadCoeffs *coeffs) {
+    bq->a1 = coeffs->a1;
+    bq->a2 = coeffs->a2;
+    bq->b0 = coeffs->b0;
+    bq->b1 = coeffs->b1;
+    bq->b2 = coeffs->b2;
+}
+
+void Aleph_Biquad_design(t_Aleph_Biquad *bq, e_Aleph_Biquad_type type,
+                         fract32 freq, fix16 q, fix16 gain) {
+    t_Aleph_BiquadCoeffs coeffs;
+
+    Aleph_BiquadCoeffs_design(&coeffs, type, freq, q, gain);
+    Aleph_Biquad_set_coeffs(bq, &coeffs);
+}
+
+void Aleph_BiquadCoeffs_design(t_Aleph_BiquadCoeffs *coeffs,
+                               e_Aleph_Biquad_type type, fract32 freq, fix16 q,
+                               fix16 gain) {
+    fract32 a0, a1, a2, b0, b1, b2;
+    fract32 sn, cs, half_sn, one_minus_cs, one_plus_cs, alpha;
+    fract32 amp, amp_plus_one, amp_minus_one, two_sqrt_amp_alpha;
+    fract32 recip_a0;
+
+    // Normalised frequency is half a cycle of int32 phase.
+    sn = sine_lookup(shl_fr1x32(freq, 1)) >> 7;
+    half_sn = sine_lookup(freq);
+
+    // 1 - cos(w) = 2 * sin^2(w / 2), accurate at low frequency.
+    one_minus_cs = mult_fr1x32x32(half_sn, half_sn) >> 6;
+    cs = sub_fr1x32(FR8_24_UNITY, one_minus_cs);
+    one_plus_cs = sub_fr1x32(FR8_24_UNITY << 1, one_minus_cs);
+
+    // alpha = sin(w) / 2q
+    alpha = _mult_8x24(sn, _recip_8x24(shl_fr1x32(q, 9)));
+
+    a0 = add_fr1x32(FR8_24_UNITY, alpha);
+    a1 = negate_fr1x32(shl_fr1x32(cs, 1));
+    a2 = sub_fr1x32(FR8_24_UNITY, alpha);
+
+    switch (type) {
+
+    case ALEPH_BIQUAD_TYPE_LPF:
+        b1 = one_minus_cs;
+        b0 = b1 >> 1;
+        b2 = b0;
+        break;
+
+    case ALEPH_BIQUAD_TYPE_HPF:
+        b0 = one_plus_cs >> 1;
+        b1 = negate_fr1x32(one_plus_cs);
+        b2 = b0;
+        break;
+
+    case ALEPH_BIQUAD_TYPE_BPF:
+        b0 = alpha;
+        b1 = 0;
+        b2 = negate_fr1x32(alpha);
+        break;
+
+    case ALEPH_BIQUAD_TYPE_NOTCH:
+        b0 = FR8_24_UNITY;
+        b1 = a1;
+        b2 = FR8_24_UNITY;
+        break;
+
+    case ALEPH_BIQUAD_TYPE_PEAK:
+        amp = shl_fr1x32(gain, 8);
+        b0 = add_fr1x32(FR8_24_UNITY, _mult_8x24(alpha, amp));
+        b1 = a1;
+        b2 = sub_fr1x32(FR8_24_UNITY, _mult_8x24(alpha, amp));
+
+        alpha = _mult_8x24(alpha, _recip_8x24(amp));
+        a0 = add_fr1x32(FR8_24_UNITY, alpha);
+        a2 = sub_fr1x32(FR8_24_UNITY, alpha);
+        break;
+
+    case ALEPH_BIQUAD_TYPE_LOWSHELF:
+    case ALEPH_BIQUAD_TYPE_HIGHSHELF:
+        amp = shl_fr1x32(gain, 8);
+        amp_plus_one = add_fr1x32(amp, FR8_24_UNITY);
+        amp_minus_one = sub_fr1x32(amp, FR8_24_UNITY);
+        two_sqrt_amp_alpha = shl_fr1x32(
+            _mult_8x24((fract32)isqrt_64((uint64_t)amp << 24), alpha), 1);
+
+        // High shelf is low shelf with the sign of cos(w) flipped.
+        if (type == ALEPH_BIQUAD_TYPE_HIGHSHELF) {
+            cs = negate_fr1x32(cs);
+        }
+
+        b0 = add_fr1x32(
+            sub_fr1x32(amp_plus_one, _mult_8x24(amp_minus_one, cs)),
+            two_sqrt_amp_alpha);
+        b0 = _mult_8x24(amp, b0);
+
+        b1 = sub_fr1x32(amp_minus_one, _mult_8x24(amp_plus_one, cs));
+        b1 = shl_fr1x32(_mult_8x24(amp, b1), 1);
+
+        b2 = sub_fr1x32(
+            sub_fr1x32(amp_plus_one, _mult_8x24(amp_minus_one, cs)),
+            two_sqrt_amp_alpha);
+        b2 = _mult_8x24(amp, b2);
+
+        a0 = add_fr1x32(
+            add_fr1x32(amp_plus_one, _mult_8x24(amp_minus_one, cs)),
+            two_sqrt_amp_alpha);
+
+        a1 = add_fr1x32(amp_minus_one, _mult_8x24(amp_plus_one, cs));
+        a1 = negate_fr1x32(shl_fr1x32(a1, 1));
+
+        a2 = sub_fr1x32(
+            add_fr1x32(amp_plus_one, _mult_8x24(amp_minus_one, cs)),
+            two_sqrt_amp_alpha);
+
+        if (type == ALEPH_BIQUAD_TYPE_HIGHSHELF) {
+            b1 = negate_fr1x32(b1);
+            a1 = negate_fr1x32(a1);
+        }
+        break;
+
+    case ALEPH_BIQUAD_TYPE_ALLPASS:
+    default:
+        b0 = a2;
+        b1 = a1;
+        b2 = a0;
+        break;
+    }
+
+    recip_a0 = _recip_8x24(a0);
+
+    coeffs->a1 = _mult_8x24(a1, recip_a0);
+    coeffs->a2 = _mult_8x24(a2, recip_a0);
+    coeffs->b0 = _mult_8x24(b0, recip_a0);
+    coeffs->b1 = _mult_8x24(b1, recip_a0);
+    coeffs->b2 = _mult_8x24(b2, recip_a0);
+}
+
+void Aleph_BiquadCascade_init(Aleph_BiquadCascade *const cascade,
+                              uint8_t num_sections, t_Aleph *const aleph) {
+
+    Aleph_BiquadCascade_init_to_pool(cascade, num_sections, &aleph->mempool);
+}
+
+void Aleph_BiquadCascade_init_to_pool(Aleph_BiquadCascade *const cascade,
+                                      uint8_t num_sections,
+                                      Mempool *const mempool) {
+
+    t_Mempool *mp = *mempool;
+
+    t_Aleph_BiquadCascade *bc = *cascade = (t_Aleph_BiquadCascade *)mpool_alloc(
+        sizeof(t_Aleph_BiquadCascade), mp);
+
+    bc->mempool = mp;
+
+    bc->num_sections = num_sections;
+
+    bc->coeffs = (t_Aleph_BiquadCoeffs *)mpool_calloc(
+        sizeof(t_Aleph_BiquadCoeffs) * num_sections, mp);
+
+    bc->state = (fract32 *)mpool_calloc(sizeof(fract32) * 4 * num_sections, mp);
+}
+
+void Aleph_BiquadCascade_free(Aleph_BiquadCascade *const cascade) {
+
+    t_Aleph_BiquadCascade *bc = *cascade;
+
+    mpool_free((char *)bc->state, bc->mempool);
+    mpool_free((char *)bc->coeffs, bc->mempool);
+    mpool_free((char *)bc, bc->mempool);
+}
+
+void Aleph_BiquadCascade_reset(Aleph_BiquadCascade *const cascade) {
+
+    t_Aleph_BiquadCascade *bc = *cascade;
+
+    int i;
+    for (i = 0; i < 4 * bc->num_sections; i++) {
+        bc->state[i] = 0;
+    }
+}
+
+void Aleph_BiquadCascade_set_coeffs(Aleph_BiquadCascade *const cascade,
+                                    uint8_t section,
+                                    t_Aleph_BiquadCoeffs *coeffs) {
+
+    t_Aleph_BiquadCascade *bc = *cascade;
+
+    bc->coeffs[section] = *coeffs;
+}
+
+void Aleph_BiquadCascade_design(Aleph_BiquadCascade *const cascade,
+                                uint8_t section, e_Aleph_Biquad_type type,
+                                fract32 freq, fix16 q, fix16 gain) {
+
+    t_Aleph_BiquadCascade *bc = *cascade;
+
+    Aleph_BiquadCoeffs_design(&bc->coeffs[section], type, freq, q, gain);
+}
+
+void Aleph_BiquadCascade_next_block(Aleph_BiquadCascade *const cascade,
+                                    fract32 *input, fract32 *output,
+                                    size_t size) {
+
+    t_Aleph_BiquadCascade *bc = *cascade;
+
+    fract32 *state = bc->state;
+
+    // Section by section over the whole block, later sections run in place.
+    int i;
+    for (i = 0; i < bc->num_sections; i++) {
+
+        _section_next_block(&bc->coeffs[i], &state[0], &state[1], &state[2],
+                            &state[3], input, output, size);
+
+        input = output;
+        state += 4;
+    }
+}
+
+void Aleph_BiquadCascade_next_block_interp(Aleph_BiquadCascade *const cascade,
+                                           t_Aleph_BiquadCoeffs *end,
+                                           fract32 *input, fract32 *output,
+                                           size_t size) {
+
+    t_Aleph_BiquadCascade *bc = *cascade;
+
+    fract32 *state = bc->state;
+
+    int i;
+    for (i = 0; i < bc->num_sections; i++) {
+
+        _section_next_block_interp(&bc->coeffs[i], &end[i], &state[0],
+                                   &state[1], &state[2], &state[3], input,
+                                   output, size);
+
+        bc->coeffs[i] = end[i];
+
+        input = output;
+        state += 4;
+    }
+}
+
 /*----- Static function implementations ------------------------------*/
 
+// Shift 8.24 products back to 1.31 and saturate.
+static inline fract32 _sat_8x24(int64_t acc) {
+    acc >>= 24;
+
+    if (acc > FR32_MAX) {
+        acc = FR32_MAX;
+    } else if (acc < FR32_MIN) {
+        acc = FR32_MIN;
+    }
+    return (fract32)acc;
+}
+
+// Full precision 8.24 multiply, MULT_FR7_24 drops the low 7 bits.
+static inline fract32 _mult_8x24(fract32 a, fract32 b) {
+    return _sat_8x24((int64_t)a * b);
+}
+
+// Direct form I, products accumulate at full precision and are shifted and
+// saturated once per sample.
+static void _section_next_block(t_Aleph_BiquadCoeffs *coeffs, fract32 *x_,
+                                fract32 *x__, fract32 *y_, fract32 *y__,
+                                fract32 *input, fract32 *output, size_t size) {
+
+    fract32 a1 = coeffs->a1;
+    fract32 a2 = coeffs->a2;
+    fract32 b0 = coeffs->b0;
+    fract32 b1 = coeffs->b1;
+    fract32 b2 = coeffs->b2;
+
+    fract32 x1 = *x_;
+    fract32 x2 = *x__;
+    fract32 y1 = *y_;
+    fract32 y2 = *y__;
+
+    fract32 x;
+    int64_t acc;
+
+    int i;
+    for (i = 0; i < size; i++) {
+
+        x = input[i];
+
+        acc = (int64_t)b0 * x;
+        acc += (int64_t)b1 * x1;
+        acc += (int64_t)b2 * x2;
+        acc -= (int64_t)a1 * y1;
+        acc -= (int64_t)a2 * y2;
+
+        x2 = x1;
+        x1 = x;
+        y2 = y1;
+        y1 = _sat_8x24(acc);
+
+        output[i] = y1;
+    }
+
+    *x_ = x1;
+    *x__ = x2;
+    *y_ = y1;
+    *y__ = y2;
+}
+
+// Newton-Raphson reciprocal of positive 8.24, result in 8.24.
+static fract32 _recip_8x24(fract32 x) {
+    int radix;
+    int i;
+    fract32 m;
+    fract32 r;
+    fract32 e;
+
+    if (x <= 0) {
+        return FR32_MAX;
+    }
+
+    // Normalise to m in [0.5, 1), x = m * 2^(7 - radix).
+    radix = norm_fr1x32(x);
+    m = shl_fr1x32(x, radix);
+
+    // r approximates 1 / m in 3.29.
+    r = sub_fr1x32(RECIP_EST_OFFSET, mult_fr1x32x32(m, RECIP_EST_SLOPE));
+
+    for (i = 0; i < RECIP_ITERATIONS; i++) {
+        // r = r * (2 - m * r)
+        e = mult_fr1x32x32(m, r);
+        r = shl_fr1x32(mult_fr1x32x32(r, sub_fr1x32(1 << 30, e)), 2);
+    }
+
+    return shl_fr1x32(r, radix - 12);
+}
+
+// As _section_next_block, coefficients step linearly from `start` to `end`.
+static void _section_next_block_interp(t_Aleph_BiquadCoeffs *start,
+                                       t_Aleph_BiquadCoeffs *end, fract32 *x_,
+                                       fract32 *x__, fract32 *y_,
+                                       fract32 *y__, fract32 *input,
+                                       fract32 *output, size_t size) {
+
+    if (size == 0) {
+        return;
+    }
+
+    fract32 a1 = start->a1;
+    fract32 a2 = start->a2;
+    fract32 b0 = start->b0;
+    fract32 b1 = start->b1;
+    fract32 b2 = start->b2;
+
+    fract32 a1_inc = sub_fr1x32(end->a1, a1) / (fract32)size;
+    fract32 a2_inc = sub_fr1x32(end->a2, a2) / (fract32)size;
+    fract32 b0_inc = sub_fr1x32(end->b0, b0) / (fract32)size;
+    fract32 b1_inc = sub_fr1x32(end->b1, b1) / (fract32)size;
+    fract32 b2_inc = sub_fr1x32(end->b2, b2) / (fract32)size;
+
+    fract32 x1 = *x_;
+    fract32 x2 = *x__;
+    fract32 y1 = *y_;
+    fract32 y2 = *y__;
+
+    fract32 x;
+    int64_t acc;
+
+    int i;
+    for (i = 0; i < size; i++) {
+
+        a1 += a1_inc;
+        a2 += a2_inc;
+        b0 += b0_inc;
+        b1 += b1_inc;
+        b2 += b2_inc;
+
+        x = input[i];
+
+        acc = (int64_t)b0 * x;
+        acc += (int64_t)b1 * x1;
+        acc += (int64_t)b2 * x2;
+        acc -= (int64_t)a1 * y1;
+        acc -= (int64_t)a2 * y2;
+
+        x2 = x1;
+        x1 = x;
+        y2 = y1;
+        y1 = _sat_8x24(acc);
+
+        output[i] = y1;
+    }
+
+    *x_ = x1;
+    *x__ = x2;
+    *y_ = y1;
+    *y__ = y2;
+}
+
 /*----- End of file --------------------------------------------------*/
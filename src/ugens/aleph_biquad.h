@@ -51,6 +51,26 @@ extern "C" {
 
 /*----- Typedefs -----------------------------------------------------*/
 
+typedef enum {
+    ALEPH_BIQUAD_TYPE_LPF,
+    ALEPH_BIQUAD_TYPE_HPF,
+    ALEPH_BIQUAD_TYPE_BPF,
+    ALEPH_BIQUAD_TYPE_NOTCH,
+    ALEPH_BIQUAD_TYPE_PEAK,
+    ALEPH_BIQUAD_TYPE_LOWSHELF,
+    ALEPH_BIQUAD_TYPE_HIGHSHELF,
+    ALEPH_BIQUAD_TYPE_ALLPASS,
+} e_Aleph_Biquad_type;
+
+// Coefficients in 8.24, normalised by a0.
+typedef struct {
+    fract32 a1;
+    fract32 a2;
+    fract32 b0;
+    fract32 b1;
+    fract32 b2;
+} t_Aleph_BiquadCoeffs;
+
 typedef struct {
     fract32 a1;
     fract32 a2;
@@ -63,6 +83,16 @@ typedef struct {
     fract32 x__;
 } t_Aleph_Biquad;
 
+// Second order sections, coefficients and state in contiguous arrays.
+typedef struct {
+    Mempool mempool;
+    uint8_t num_sections;
+    t_Aleph_BiquadCoeffs *coeffs;
+    fract32 *state; // x_, x__, y_, y__ per section.
+} t_Aleph_BiquadCascade;
+
+typedef t_Aleph_BiquadCascade *Aleph_BiquadCascade;
+
 /*----- Extern variable declarations ---------------------------------*/
 
 /*----- Extern function prototypes -----------------------------------*/
@@ -71,10 +101,66 @@ void Aleph_Biquad_init(t_Aleph_Biquad *bq);
 
 fract32 Aleph_Biquad_next(t_Aleph_Biquad *bq, fract32 x);
 
+void Aleph_Biquad_next_block(t_Aleph_Biquad *bq, fract32 *input,
+                             fract32 *output, size_t size);
+
+// Interpolate linearly from the current coefficients to `end` over the
+// block, then set `end`. Redesign at control rate without zipper noise.
+void Aleph_Biquad_next_block_interp(t_Aleph_Biquad *bq,
+                                    t_Aleph_BiquadCoeffs *end, fract32 *input,
+                                    fract32 *output, size_t size);
+
 void Aleph_Biquad_set_lpf(t_Aleph_Biquad *bq, float freq, float q);
 
 void Aleph_Biquad_set_coeffs_from_floats(t_Aleph_Biquad *bq, float a1, float a2,
                                          float b0, float b1, float b2);
+
+void Aleph_Biquad_set_coeffs(t_Aleph_Biquad *bq, t_Aleph_BiquadCoeffs *coeffs);
+
+// Fixed point RBJ cookbook design, cheap enough to run at control rate.
+//
+// `freq` is normalised, FR32_MAX is the sample rate (see
+// Aleph_normalise_frequency()), valid up to Nyquist.
+// `q` is fix16, must be greater than zero.
+// `gain` is fix16 linear amplitude, A = 10^(dB/40), used by PEAK,
+// LOWSHELF and HIGHSHELF only. Shelves saturate for A above about 8.
+void Aleph_Biquad_design(t_Aleph_Biquad *bq, e_Aleph_Biquad_type type,
+                         fract32 freq, fix16 q, fix16 gain);
+
+void Aleph_BiquadCoeffs_design(t_Aleph_BiquadCoeffs *coeffs,
+                               e_Aleph_Biquad_type type, fract32 freq, fix16 q,
+                               fix16 gain);
+
+void Aleph_BiquadCascade_init(Aleph_BiquadCascade *const cascade,
+                              uint8_t num_sections, t_Aleph *const aleph);
+
+void Aleph_BiquadCascade_init_to_pool(Aleph_BiquadCascade *const cascade,
+                                      uint8_t num_sections,
+                                      Mempool *const mempool);
+
+void Aleph_BiquadCascade_free(Aleph_BiquadCascade *const cascade);
+
+void Aleph_BiquadCascade_reset(Aleph_BiquadCascade *const cascade);
+
+void Aleph_BiquadCascade_set_coeffs(Aleph_BiquadCascade *const cascade,
+                                    uint8_t section,
+                                    t_Aleph_BiquadCoeffs *coeffs);
+
+void Aleph_BiquadCascade_design(Aleph_BiquadCascade *const cascade,
+                                uint8_t section, e_Aleph_Biquad_type type,
+                                fract32 freq, fix16 q, fix16 gain);
+
+// Allows using same buffer for input and output.
+void Aleph_BiquadCascade_next_block(Aleph_BiquadCascade *const cascade,
+                                    fract32 *input, fract32 *output,
+                                    size_t size);
+
+// `end` holds one coefficient set per section.
+void Aleph_BiquadCascade_next_block_interp(Aleph_BiquadCascade *const cascade,
+                                           t_Aleph_BiquadCoeffs *end,
+                                           fract32 *input, fract32 *output,
+                                           size_t size);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,341 @@
+/*----------------------------------------------------------------------
+
+                     This file is part of Aleph DSP
+
+                https://github.com/bangcorrupt/aleph-dsp
+
+         Aleph DSP is based on monome/aleph and spiricom/LEAF.
+
+                              MIT License
+
+            Aleph dedicated to the public domain by monome.
+
+                LEAF Copyright Jeff Snyder et. al. 2020
+
+                       Copyright bangcorrupt 2024
+
+----------------------------------------------------------------------*/
+/**
+ * @file    aleph_convolver.c
+ *
+ * @brief   Partitioned FFT convolution.
+ *
+ *          Input spectra are stored at a fixed exponent and each IR
+ *          partition at its own exponent, so quiet partitions keep their
+ *          full mantissa. Products are aligned to the largest IR exponent
+ *          and summed in 64 bits, small contributions from the tail of the
+ *          IR are not lost to truncation.
+ */
+
+/*----- Includes -----------------------------------------------------*/
+
+#include "aleph.h"
+
+#include "aleph_convolver.h"
+#include "aleph_fft.h"
+
+/*----- Macros -------------------------------------------------------*/
+
+/*----- Typedefs -----------------------------------------------------*/
+
+/*----- Static variable definitions ----------------------------------*/
+
+/*----- Extern variable definitions ----------------------------------*/
+
+/*----- Static function prototypes -----------------------------------*/
+
+static int _partition_spectrum(t_Aleph_Convolver *cv, fract32 *ir,
+                               size_t length, uint16_t partition,
+                               fract32 *spectrum);
+static void _spectrum_mac(fract32 *x, fract32 *h, int64_t *accum,
+                          uint16_t size, int shift);
+static int _normalise(int64_t *accum, fract32 *output, uint16_t size);
+
+/*----- Extern function implementations ------------------------------*/
+
+void Aleph_Convolver_init(Aleph_Convolver *const convolver,
+                          uint8_t log2_block_size, size_t max_ir_length,
+                          t_Aleph *const aleph) {
+
+    Aleph_Convolver_init_to_pool(convolver, log2_block_size, max_ir_length,
+                                 &aleph->mempool);
+}
+
+void Aleph_Convolver_init_to_pool(Aleph_Convolver *const convolver,
+                                  uint8_t log2_block_size,
+                                  size_t max_ir_length,
+                                  Mempool *const mempool) {
+
+    Aleph_Convolver_init_to_pools(convolver, log2_block_size, max_ir_length,
+                                  mempool, mempool);
+}
+
+void Aleph_Convolver_init_to_pools(Aleph_Convolver *const convolver,
+                                   uint8_t log2_block_size,
+                                   size_t max_ir_length,
+                                   Mempool *const mempool,
+                                   Mempool *const ir_mempool) {
+
+    t_Mempool *mp = *mempool;
+    t_Mempool *ip = *ir_mempool;
+
+    t_Aleph_Convolver *cv = *convolver =
+        (t_Aleph_Convolver *)mpool_alloc(sizeof(t_Aleph_Convolver), mp);
+
+    cv->mempool = mp;
+    cv->ir_mempool = ip;
+
+    // Real FFT of two blocks is a complex FFT of one block.
+    Aleph_FFT_init_to_pool(&cv->fft, log2_block_size, mempool);
+
+    cv->log2_block_size = cv->fft->log2_size;
+    cv->block_size = cv->fft->size;
+
+    cv->max_partitions =
+        (max_ir_length + cv->block_size - 1) >> cv->log2_block_size;
+
+    if (cv->max_partitions < 1) {
+        cv->max_partitions = 1;
+    }
+
+    cv->num_partitions = 0;
+    cv->ir_exponent = 0;
+
+    // Largest real spectrum of two blocks is 2 * block_size.
+    cv->input_exponent = cv->log2_block_size + 1;
+
+    // Headroom for the complex product and the sum over partitions.
+    cv->guard = 1;
+    while ((1 << (cv->guard - 1)) < cv->max_partitions) {
+        cv->guard++;
+    }
+
+    cv->ir = (fract32 *)mpool_calloc(
+        sizeof(fract32) * 2 * cv->block_size * cv->max_partitions, ip);
+
+    cv->ir_exponents =
+        (int8_t *)mpool_calloc(sizeof(int8_t) * cv->max_partitions, ip);
+
+    cv->fdl = (fract32 *)mpool_calloc(
+        sizeof(fract32) * 2 * cv->block_size * cv->max_partitions, mp);
+
+    cv->input = (fract32 *)mpool_calloc(sizeof(fract32) * 2 * cv->block_size,
+                                        mp);
+
+    cv->output = (fract32 *)mpool_calloc(sizeof(fract32) * 2 * cv->block_size,
+                                         mp);
+
+    cv->accum = (int64_t *)mpool_calloc(sizeof(int64_t) * 2 * cv->block_size,
+                                        mp);
+
+    cv->fdl_index = 0;
+}
+
+void Aleph_Convolver_free(Aleph_Convolver *const convolver) {
+
+    t_Aleph_Convolver *cv = *convolver;
+
+    mpool_free((char *)cv->accum, cv->mempool);
+    mpool_free((char *)cv->output, cv->mempool);
+    mpool_free((char *)cv->input, cv->mempool);
+    mpool_free((char *)cv->fdl, cv->mempool);
+    mpool_free((char *)cv->ir_exponents, cv->ir_mempool);
+    mpool_free((char *)cv->ir, cv->ir_mempool);
+
+    Aleph_FFT_free(&cv->fft);
+
+    mpool_free((char *)cv, cv->mempool);
+}
+
+void Aleph_Convolver_reset(Aleph_Convolver *const convolver) {
+
+    t_Aleph_Convolver *cv = *convolver;
+
+    int i;
+    for (i = 0; i < 2 * cv->block_size * cv->max_partitions; i++) {
+        cv->fdl[i] = 0;
+    }
+
+    for (i = 0; i < 2 * cv->block_size; i++) {
+        cv->input[i] = 0;
+    }
+
+    cv->fdl_index = 0;
+}
+
+void Aleph_Convolver_set_ir(Aleph_Convolver *const convolver, fract32 *ir,
+                            size_t length) {
+
+    t_Aleph_Convolver *cv = *convolver;
+
+    uint16_t num_partitions =
+        (length + cv->block_size - 1) >> cv->log2_block_size;
+    int exponent = 0;
+    int e;
+    fract32 *spectrum;
+
+    if (num_partitions > cv->max_partitions) {
+        num_partitions = cv->max_partitions;
+    }
+
+    // Spectra keep their own exponent, products are aligned in the sum.
+    int p;
+    for (p = 0; p < num_partitions; p++) {
+
+        spectrum = cv->ir + 2 * cv->block_size * p;
+
+        e = _partition_spectrum(cv, ir, length, p, spectrum);
+
+        cv->ir_exponents[p] = e;
+
+        if (e > exponent) {
+            exponent = e;
+        }
+    }
+
+    cv->ir_exponent = exponent;
+    cv->num_partitions = num_partitions;
+}
+
+void Aleph_Convolver_next_block(Aleph_Convolver *const convolver,
+                                fract32 *input, fract32 *output,
+                                size_t size) {
+
+    t_Aleph_Convolver *cv = *convolver;
+
+    uint16_t n = cv->block_size;
+    uint16_t slot;
+    fract32 *spectrum;
+    int e, shift, align;
+
+    int i, p;
+
+    // Slide the input window by one block.
+    for (i = 0; i < n; i++) {
+        cv->input[i] = cv->input[n + i];
+        cv->input[n + i] = input[i];
+    }
+
+    // Newest input spectrum into the frequency domain delay line.
+    spectrum = cv->fdl + 2 * n * cv->fdl_index;
+
+    for (i = 0; i < 2 * n; i++) {
+        spectrum[i] = cv->input[i];
+    }
+
+    e = Aleph_FFT_real_forward(&cv->fft, spectrum);
+
+    for (i = 0; i < 2 * n; i++) {
+        spectrum[i] = shl_fr1x32(spectrum[i], e - cv->input_exponent);
+    }
+
+    // Sum of products, partition p meets the input from p blocks ago.
+    for (i = 0; i < 2 * n; i++) {
+        cv->accum[i] = 0;
+    }
+
+    slot = cv->fdl_index;
+
+    for (p = 0; p < cv->num_partitions; p++) {
+
+        // Quieter partitions are shifted down to the largest exponent.
+        align = cv->guard + cv->ir_exponent - cv->ir_exponents[p];
+
+        if (align < 63) {
+            _spectrum_mac(cv->fdl + 2 * n * slot, cv->ir + 2 * n * p,
+                          cv->accum, n, align);
+        }
+
+        slot = slot == 0 ? cv->max_partitions - 1 : slot - 1;
+    }
+
+    if (++cv->fdl_index >= cv->max_partitions) {
+        cv->fdl_index = 0;
+    }
+
+    // Products are Q62, shifted right by guard bits.
+    shift = _normalise(cv->accum, cv->output, n) + cv->guard +
+            cv->input_exponent + cv->ir_exponent - 31;
+
+    // Inverse is unnormalised, gains block_size.
+    shift += Aleph_FFT_real_inverse(&cv->fft, cv->output) -
+             cv->log2_block_size;
+
+    // Overlap-save, keep the second half.
+    for (i = 0; i < n; i++) {
+        output[i] = shl_fr1x32(cv->output[n + i], shift);
+    }
+}
+
+/*----- Static function implementations ------------------------------*/
+
+// Partition zero padded to two blocks, returns block exponent.
+static int _partition_spectrum(t_Aleph_Convolver *cv, fract32 *ir,
+                               size_t length, uint16_t partition,
+                               fract32 *spectrum) {
+
+    size_t start = partition << cv->log2_block_size;
+
+    int i;
+    for (i = 0; i < 2 * cv->block_size; i++) {
+
+        if (i < cv->block_size && start + i < length) {
+            spectrum[i] = ir[start + i];
+        } else {
+            spectrum[i] = 0;
+        }
+    }
+
+    return Aleph_FFT_real_forward(&cv->fft, spectrum);
+}
+
+// Packed real spectra, DC and Nyquist are real.
+static void _spectrum_mac(fract32 *x, fract32 *h, int64_t *accum,
+                          uint16_t size, int shift) {
+
+    int64_t xr, xi, hr, hi;
+
+    accum[0] += ((int64_t)x[0] * h[0]) >> shift;
+    accum[1] += ((int64_t)x[1] * h[1]) >> shift;
+
+    int k;
+    for (k = 2; k < 2 * size; k += 2) {
+
+        xr = x[k];
+        xi = x[k + 1];
+        hr = h[k];
+        hi = h[k + 1];
+
+        accum[k] += (xr * hr - xi * hi) >> shift;
+        accum[k + 1] += (xr * hi + xi * hr) >> shift;
+    }
+}
+
+// Block floating point back to fract32, returns the shift applied.
+static int _normalise(int64_t *accum, fract32 *output, uint16_t size) {
+
+    uint64_t max = 0;
+    int bits = 0;
+    int shift;
+
+    int i;
+    for (i = 0; i < 2 * size; i++) {
+        max |= accum[i] < 0 ? -accum[i] : accum[i];
+    }
+
+    while (max >> bits) {
+        bits++;
+    }
+
+    // Largest magnitude just below 2^31.
+    shift = bits - 31;
+
+    for (i = 0; i < 2 * size; i++) {
+        output[i] = (fract32)(shift >= 0 ? accum[i] >> shift
+                                         : accum[i] << -shift);
+    }
+
+    return shift;
+}
+
+/*----- End of file --------------------------------------------------*/
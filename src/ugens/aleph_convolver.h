@@ -0,0 +1,105 @@
+/*----------------------------------------------------------------------
+
+                     This file is part of Aleph DSP
+
+                https://github.com/bangcorrupt/aleph-dsp
+
+         Aleph DSP is based on monome/aleph and spiricom/LEAF.
+
+                              MIT License
+
+            Aleph dedicated to the public domain by monome.
+
+                LEAF Copyright Jeff Snyder et. al. 2020
+
+                       Copyright bangcorrupt 2024
+
+----------------------------------------------------------------------*/
+/**
+ * @file    aleph_convolver.h
+ *
+ * @brief   Public API for partitioned FFT convolution.
+ *
+ *          Uniformly partitioned overlap-save. The impulse response is
+ *          split into partitions of one audio block, each held as a
+ *          spectrum, and the spectra of past input blocks are kept in a
+ *          frequency domain delay line. Latency is one block.
+ *
+ *          IR spectra may be allocated from a separate pool, e.g. SDRAM.
+ */
+
+#ifndef ALEPH_CONVOLVER_H
+#define ALEPH_CONVOLVER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*----- Includes -----------------------------------------------------*/
+
+#include "aleph.h"
+
+#include "aleph_fft.h"
+
+/*----- Macros -------------------------------------------------------*/
+
+/*----- Typedefs -----------------------------------------------------*/
+
+typedef struct {
+    Mempool mempool;
+    Mempool ir_mempool;
+    Aleph_FFT fft;
+    uint16_t block_size;
+    uint8_t log2_block_size;
+    uint16_t max_partitions;
+    uint16_t num_partitions;
+    uint16_t fdl_index;
+    int input_exponent;
+    int ir_exponent;      // Largest of ir_exponents.
+    int8_t *ir_exponents; // Block exponent of each partition spectrum.
+    int guard;
+    fract32 *ir;    // Partition spectra, 2 * block_size each.
+    fract32 *fdl;   // Input spectra, 2 * block_size each.
+    fract32 *input; // Previous and current input block.
+    fract32 *output;
+    int64_t *accum;
+} t_Aleph_Convolver;
+
+typedef t_Aleph_Convolver *Aleph_Convolver;
+
+/*----- Extern variable declarations ---------------------------------*/
+
+/*----- Extern function prototypes -----------------------------------*/
+
+void Aleph_Convolver_init(Aleph_Convolver *const convolver,
+                          uint8_t log2_block_size, size_t max_ir_length,
+                          t_Aleph *const aleph);
+void Aleph_Convolver_init_to_pool(Aleph_Convolver *const convolver,
+                                  uint8_t log2_block_size,
+                                  size_t max_ir_length,
+                                  Mempool *const mempool);
+void Aleph_Convolver_init_to_pools(Aleph_Convolver *const convolver,
+                                   uint8_t log2_block_size,
+                                   size_t max_ir_length,
+                                   Mempool *const mempool,
+                                   Mempool *const ir_mempool);
+void Aleph_Convolver_free(Aleph_Convolver *const convolver);
+
+void Aleph_Convolver_reset(Aleph_Convolver *const convolver);
+
+// Transforms every partition, call outside the audio callback.
+void Aleph_Convolver_set_ir(Aleph_Convolver *const convolver, fract32 *ir,
+                            size_t length);
+
+// Size must equal the block size.
+// Allows using same buffer for input and output.
+void Aleph_Convolver_next_block(Aleph_Convolver *const convolver,
+                                fract32 *input, fract32 *output,
+                                size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+/*----- End of file --------------------------------------------------*/
@@ -0,0 +1,166 @@
+/*----------------------------------------------------------------------
+
+                     This file is part of Aleph DSP
+
+                https://github.com/bangcorrupt/aleph-dsp
+
+         Aleph DSP is based on monome/aleph and spiricom/LEAF.
+
+                              MIT License
+
+            Aleph dedicated to the public domain by monome.
+
+                LEAF Copyright Jeff Snyder et. al. 2020
+
+                       Copyright bangcorrupt 2024
+
+----------------------------------------------------------------------*/
+
+/**
+ * @file    aleph_cutoff_table.c
+ *
+ * @brief   Exponential cutoff lookup table.
+ */
+
+/*----- Includes -----------------------------------------------------*/
+
+#include "aleph.h"
+
+#include "aleph_sine_table.h"
+
+#include "aleph_cutoff_table.h"
+
+/*----- Macros -------------------------------------------------------*/
+
+// MIDI note 0 in Hz, fix16.
+#define CUTOFF_TABLE_BASE_FREQ (535809)
+
+#define CUTOFF_TABLE_MAX_PITCH ((ALEPH_CUTOFF_TABLE_SIZE << 16) - 1)
+
+/*----- Typedefs -----------------------------------------------------*/
+
+/*----- Static variable definitions ----------------------------------*/
+
+// 2^(n/12) in 2.30 radix.
+static const fract32 s_semitone_ratio[12] = {
+    0x40000000, 0x43CE3E4B, 0x47D66B0F, 0x4C1BF829, 0x50A28BE6, 0x556E0424,
+    0x5A82799A, 0x5FE4435E, 0x6597FA95, 0x6BA27E65, 0x7208F81D, 0x78D0DF9C,
+};
+
+/*----- Extern variable definitions ----------------------------------*/
+
+/*----- Static function prototypes -----------------------------------*/
+
+/*----- Extern function implementations ------------------------------*/
+
+void Aleph_CutoffTable_init(Aleph_CutoffTable *const table,
+                            t_Aleph *const aleph) {
+
+    Aleph_CutoffTable_init_to_pool(table, &aleph->mempool);
+}
+
+void Aleph_CutoffTable_init_to_pool(Aleph_CutoffTable *const table,
+                                    Mempool *const mempool) {
+
+    t_Mempool *mp = *mempool;
+
+    t_Aleph_CutoffTable *ct = *table =
+        (t_Aleph_CutoffTable *)mpool_alloc(sizeof(t_Aleph_CutoffTable), mp);
+
+    ct->mempool = mp;
+
+    ct->oversample = ALEPH_CUTOFF_TABLE_DEFAULT_OVERSAMPLE;
+
+    Aleph_CutoffTable_update(table);
+}
+
+void Aleph_CutoffTable_free(Aleph_CutoffTable *const table) {
+
+    t_Aleph_CutoffTable *ct = *table;
+
+    mpool_free((char *)ct, ct->mempool);
+}
+
+void Aleph_CutoffTable_update(Aleph_CutoffTable *const table) {
+
+    t_Aleph_CutoffTable *ct = *table;
+
+    fix16 hz;
+    fract32 freq;
+
+    int i;
+    for (i = 0; i <= ALEPH_CUTOFF_TABLE_SIZE; i++) {
+
+        // Octave by shift, semitone by ratio, no exp at runtime.
+        hz = shl_fr1x32(mult_fr1x32x32(CUTOFF_TABLE_BASE_FREQ << (i / 12),
+                                       s_semitone_ratio[i % 12]),
+                        1);
+
+        freq = Aleph_normalise_frequency(ct->mempool->aleph, hz);
+
+        // 2 * sin(pi * fc / fs), normalised frequency is half a cycle of
+        // int32 phase.
+        ct->table[i] = shl_fr1x32(sine_lookup(freq / ct->oversample), 1);
+    }
+}
+
+void Aleph_CutoffTable_set_oversample(Aleph_CutoffTable *const table,
+                                      uint8_t oversample) {
+
+    t_Aleph_CutoffTable *ct = *table;
+
+    ct->oversample = oversample;
+
+    Aleph_CutoffTable_update(table);
+}
+
+fract32 Aleph_CutoffTable_lookup(Aleph_CutoffTable *const table, fix16 pitch) {
+
+    t_Aleph_CutoffTable *ct = *table;
+
+    if (pitch < 0) {
+        pitch = 0;
+    } else if (pitch > CUTOFF_TABLE_MAX_PITCH) {
+        pitch = CUTOFF_TABLE_MAX_PITCH;
+    }
+
+    int idx = pitch >> 16;
+    fract32 frac = (pitch & 0xFFFF) << 15;
+
+    return add_fr1x32(
+        ct->table[idx],
+        mult_fr1x32x32(sub_fr1x32(ct->table[idx + 1], ct->table[idx]), frac));
+}
+
+void Aleph_CutoffTable_lookup_block(Aleph_CutoffTable *const table,
+                                    fix16 *pitch, fract32 *output,
+                                    size_t size) {
+
+    t_Aleph_CutoffTable *ct = *table;
+
+    fract32 *tab = ct->table;
+    fix16 p;
+    int idx;
+
+    int i;
+    for (i = 0; i < size; i++) {
+
+        p = pitch[i];
+
+        if (p < 0) {
+            p = 0;
+        } else if (p > CUTOFF_TABLE_MAX_PITCH) {
+            p = CUTOFF_TABLE_MAX_PITCH;
+        }
+
+        idx = p >> 16;
+
+        output[i] = add_fr1x32(
+            tab[idx], mult_fr1x32x32(sub_fr1x32(tab[idx + 1], tab[idx]),
+                                     (p & 0xFFFF) << 15));
+    }
+}
+
+/*----- Static function implementations ------------------------------*/
+
+/*----- End of file --------------------------------------------------*/
@@ -0,0 +1,90 @@
+/*----------------------------------------------------------------------
+
+                     This file is part of Aleph DSP
+
+                https://github.com/bangcorrupt/aleph-dsp
+
+         Aleph DSP is based on monome/aleph and spiricom/LEAF.
+
+                              MIT License
+
+            Aleph dedicated to the public domain by monome.
+
+                LEAF Copyright Jeff Snyder et. al. 2020
+
+                       Copyright bangcorrupt 2024
+
+----------------------------------------------------------------------*/
+
+/**
+ * @file    aleph_cutoff_table.h
+ *
+ * @brief   Public API for exponential cutoff lookup table.
+ *
+ *          Maps pitch in semitones to state-variable filter coefficient,
+ *          so modulation can be summed in pitch space.
+ */
+
+#ifndef ALEPH_CUTOFF_TABLE_H
+#define ALEPH_CUTOFF_TABLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*----- Includes -----------------------------------------------------*/
+
+#include "aleph.h"
+
+/*----- Macros -------------------------------------------------------*/
+
+// One entry per semitone, MIDI note 0 (8.18 Hz) to 128.
+#define ALEPH_CUTOFF_TABLE_SIZE (128)
+
+#define ALEPH_CUTOFF_TABLE_DEFAULT_OVERSAMPLE (1)
+
+// Pitch of MIDI note 69 (A4, 440 Hz) in 16.16 semitones.
+#define ALEPH_CUTOFF_TABLE_A4 (69 << 16)
+
+/*----- Typedefs -----------------------------------------------------*/
+
+typedef struct {
+    Mempool mempool;
+    uint8_t oversample; // filter frames per sample, 2 for `_os_` SVF
+    fract32 table[ALEPH_CUTOFF_TABLE_SIZE + 1];
+} t_Aleph_CutoffTable;
+
+typedef t_Aleph_CutoffTable *Aleph_CutoffTable;
+
+/*----- Extern variable declarations ---------------------------------*/
+
+/*----- Extern function prototypes -----------------------------------*/
+
+void Aleph_CutoffTable_init(Aleph_CutoffTable *const table,
+                            t_Aleph *const aleph);
+void Aleph_CutoffTable_init_to_pool(Aleph_CutoffTable *const table,
+                                    Mempool *const mempool);
+void Aleph_CutoffTable_free(Aleph_CutoffTable *const table);
+
+// Rebuild the table, call after changing the Aleph sample rate.
+void Aleph_CutoffTable_update(Aleph_CutoffTable *const table);
+
+void Aleph_CutoffTable_set_oversample(Aleph_CutoffTable *const table,
+                                      uint8_t oversample);
+
+// Pitch is semitones in 16.16 radix (MIDI note number), returns
+// 2 * sin(pi * fc / (fs * oversample)) for Aleph_FilterSVF_set_coeff().
+// Saturates at fract32 unity, fc = fs * oversample / 6.
+fract32 Aleph_CutoffTable_lookup(Aleph_CutoffTable *const table, fix16 pitch);
+
+// Allows using same buffer for input and output.
+void Aleph_CutoffTable_lookup_block(Aleph_CutoffTable *const table,
+                                    fix16 *pitch, fract32 *output,
+                                    size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+/*----- End of file --------------------------------------------------*/
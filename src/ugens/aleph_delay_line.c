@@ -0,0 +1,387 @@
+/*----------------------------------------------------------------------
+
+                     This file is part of Aleph DSP
+
+                https://github.com/bangcorrupt/aleph-dsp
+
+         Aleph DSP is based on monome/aleph and spiricom/LEAF.
+
+                              MIT License
+
+            Aleph dedicated to the public domain by monome.
+
+                LEAF Copyright Jeff Snyder et. al. 2020
+
+                       Copyright bangcorrupt 2024
+
+----------------------------------------------------------------------*/
+/**
+ * @file    aleph_delay_line.c
+ *
+ * @brief   Fractional delay line.
+ *
+ *          First order allpass interpolation keeps the fractional part of
+ *          the delay in [0.5, 1.5), where the coefficient stays small and
+ *          the filter is well conditioned.
+ */
+
+/*----- Includes -----------------------------------------------------*/
+
+#include "aleph.h"
+
+#include "aleph_delay_line.h"
+
+/*----- Macros -------------------------------------------------------*/
+
+#define DELAYLINE_HALF (0x40000000)
+
+/*----- Typedefs -----------------------------------------------------*/
+
+/*----- Static variable definitions ----------------------------------*/
+
+/*----- Extern variable definitions ----------------------------------*/
+
+/*----- Static function prototypes -----------------------------------*/
+
+static inline uint32_t _allpass_offset(t_Aleph_DelayTap *tap);
+static inline fract32 _linear(fract32 *buf, uint32_t mask, uint32_t p,
+                              fract32 frac);
+static inline fract32 _bspline(fract32 *buf, uint32_t mask, uint32_t p,
+                               fract32 frac);
+static inline fract32 _allpass(fract32 *buf, uint32_t mask, uint32_t p,
+                               fract32 coeff, fract32 *state);
+
+/*----- Extern function implementations ------------------------------*/
+
+void Aleph_DelayLine_init(Aleph_DelayLine *const delay, uint32_t size,
+                          t_Aleph *const aleph) {
+
+    Aleph_DelayLine_init_to_pool(delay, size, &aleph->mempool);
+}
+
+void Aleph_DelayLine_init_to_pool(Aleph_DelayLine *const delay, uint32_t size,
+                                  Mempool *const mempool) {
+
+    t_Mempool *mp = *mempool;
+
+    t_Aleph_DelayLine *dl = *delay =
+        (t_Aleph_DelayLine *)mpool_alloc(sizeof(t_Aleph_DelayLine), mp);
+
+    dl->mempool = mp;
+
+    // Round up to power of two, wrap with a mask.
+    dl->size = 1;
+    while (dl->size < size) {
+        dl->size <<= 1;
+    }
+
+    dl->mask = dl->size - 1;
+    dl->write = 0;
+    dl->interp = ALEPH_DELAYLINE_INTERP_LINEAR;
+
+    dl->buffer = (fract32 *)mpool_calloc(sizeof(fract32) * dl->size, mp);
+}
+
+void Aleph_DelayLine_free(Aleph_DelayLine *const delay) {
+
+    t_Aleph_DelayLine *dl = *delay;
+
+    mpool_free((char *)dl->buffer, dl->mempool);
+    mpool_free((char *)dl, dl->mempool);
+}
+
+void Aleph_DelayLine_clear(Aleph_DelayLine *const delay) {
+
+    t_Aleph_DelayLine *dl = *delay;
+
+    int i;
+    for (i = 0; i < dl->size; i++) {
+        dl->buffer[i] = 0;
+    }
+
+    dl->write = 0;
+}
+
+void Aleph_DelayLine_set_interp(Aleph_DelayLine *const delay,
+                                e_Aleph_DelayLine_interp interp) {
+
+    t_Aleph_DelayLine *dl = *delay;
+
+    dl->interp = interp;
+}
+
+void Aleph_DelayLine_write(Aleph_DelayLine *const delay, fract32 input) {
+
+    t_Aleph_DelayLine *dl = *delay;
+
+    dl->buffer[dl->write] = input;
+    dl->write = (dl->write + 1) & dl->mask;
+}
+
+void Aleph_DelayLine_write_block(Aleph_DelayLine *const delay, fract32 *input,
+                                 size_t size) {
+
+    t_Aleph_DelayLine *dl = *delay;
+
+    fract32 *buf = dl->buffer;
+    uint32_t mask = dl->mask;
+    uint32_t w = dl->write;
+
+    int i;
+    for (i = 0; i < size; i++) {
+        buf[w] = input[i];
+        w = (w + 1) & mask;
+    }
+
+    dl->write = w;
+}
+
+fract32 Aleph_DelayLine_read(Aleph_DelayLine *const delay,
+                             t_Aleph_DelayTap *tap) {
+
+    t_Aleph_DelayLine *dl = *delay;
+
+    // Index of the last sample written.
+    uint32_t last = dl->write - 1;
+
+    switch (dl->interp) {
+
+    case ALEPH_DELAYLINE_INTERP_NONE:
+        return dl->buffer[(last - tap->offset) & dl->mask];
+
+    case ALEPH_DELAYLINE_INTERP_BSPLINE:
+        return _bspline(dl->buffer, dl->mask, last - tap->offset, tap->frac);
+
+    case ALEPH_DELAYLINE_INTERP_ALLPASS:
+        return _allpass(dl->buffer, dl->mask, last - _allpass_offset(tap),
+                        tap->coeff, &tap->state);
+
+    default:
+        return _linear(dl->buffer, dl->mask, last - tap->offset, tap->frac);
+    }
+}
+
+void Aleph_DelayLine_read_block(Aleph_DelayLine *const delay,
+                                t_Aleph_DelayTap *tap, fract32 *output,
+                                size_t size) {
+
+    t_Aleph_DelayLine *dl = *delay;
+
+    fract32 *buf = dl->buffer;
+    uint32_t mask = dl->mask;
+
+    // Index of the first sample of the last block written.
+    uint32_t first = dl->write - size;
+    uint32_t p;
+
+    int i;
+
+    switch (dl->interp) {
+
+    case ALEPH_DELAYLINE_INTERP_NONE:
+        p = first - tap->offset;
+        for (i = 0; i < size; i++) {
+            output[i] = buf[(p + i) & mask];
+        }
+        break;
+
+    case ALEPH_DELAYLINE_INTERP_BSPLINE:
+        p = first - tap->offset;
+        for (i = 0; i < size; i++) {
+            output[i] = _bspline(buf, mask, p + i, tap->frac);
+        }
+        break;
+
+    case ALEPH_DELAYLINE_INTERP_ALLPASS:
+        p = first - _allpass_offset(tap);
+        for (i = 0; i < size; i++) {
+            output[i] = _allpass(buf, mask, p + i, tap->coeff, &tap->state);
+        }
+        break;
+
+    default:
+        p = first - tap->offset;
+        for (i = 0; i < size; i++) {
+            output[i] = _linear(buf, mask, p + i, tap->frac);
+        }
+        break;
+    }
+}
+
+void Aleph_DelayLine_read_block_taps(Aleph_DelayLine *const delay,
+                                     t_Aleph_DelayTap *taps, fract32 *gains,
+                                     uint8_t num_taps, fract32 *output,
+                                     size_t size) {
+
+    t_Aleph_DelayLine *dl = *delay;
+
+    fract32 *buf = dl->buffer;
+    uint32_t mask = dl->mask;
+    uint32_t first = dl->write - size;
+    uint32_t p;
+    fract32 x;
+
+    t_Aleph_DelayTap *tap;
+    fract32 gain;
+
+    int i;
+    for (i = 0; i < size; i++) {
+        output[i] = 0;
+    }
+
+    int t;
+    for (t = 0; t < num_taps; t++) {
+
+        tap = &taps[t];
+        gain = gains[t];
+
+        switch (dl->interp) {
+
+        case ALEPH_DELAYLINE_INTERP_NONE:
+            p = first - tap->offset;
+            for (i = 0; i < size; i++) {
+                x = buf[(p + i) & mask];
+                output[i] = add_fr1x32(output[i], mult_fr1x32x32(x, gain));
+            }
+            break;
+
+        case ALEPH_DELAYLINE_INTERP_BSPLINE:
+            p = first - tap->offset;
+            for (i = 0; i < size; i++) {
+                x = _bspline(buf, mask, p + i, tap->frac);
+                output[i] = add_fr1x32(output[i], mult_fr1x32x32(x, gain));
+            }
+            break;
+
+        case ALEPH_DELAYLINE_INTERP_ALLPASS:
+            p = first - _allpass_offset(tap);
+            for (i = 0; i < size; i++) {
+                x = _allpass(buf, mask, p + i, tap->coeff, &tap->state);
+                output[i] = add_fr1x32(output[i], mult_fr1x32x32(x, gain));
+            }
+            break;
+
+        default:
+            p = first - tap->offset;
+            for (i = 0; i < size; i++) {
+                x = _linear(buf, mask, p + i, tap->frac);
+                output[i] = add_fr1x32(output[i], mult_fr1x32x32(x, gain));
+            }
+            break;
+        }
+    }
+}
+
+void Aleph_DelayLine_read_block_ramp(Aleph_DelayLine *const delay,
+                                     t_Aleph_DelayTap *tap,
+                                     t_Aleph_Ramp *ramp, fract32 *output,
+                                     size_t size) {
+
+    t_Aleph_DelayLine *dl = *delay;
+
+    fract32 *buf = dl->buffer;
+    uint32_t mask = dl->mask;
+    uint32_t first = dl->write - size;
+
+    fix16 d = ramp->start;
+    fix16 inc = ramp->inc;
+    uint32_t p;
+    fract32 frac;
+
+    int i;
+
+    switch (dl->interp) {
+
+    case ALEPH_DELAYLINE_INTERP_NONE:
+        for (i = 0; i < size; i++) {
+            d = add_fr1x32(d, inc);
+            output[i] = buf[(first + i - (d >> 16)) & mask];
+        }
+        break;
+
+    case ALEPH_DELAYLINE_INTERP_BSPLINE:
+        for (i = 0; i < size; i++) {
+            d = add_fr1x32(d, inc);
+            p = first + i - (d >> 16);
+            frac = (d & 0xFFFF) << 15;
+            output[i] = _bspline(buf, mask, p, frac);
+        }
+        break;
+
+    default:
+        // Allpass state is not valid under modulation, use linear.
+        for (i = 0; i < size; i++) {
+            d = add_fr1x32(d, inc);
+            p = first + i - (d >> 16);
+            frac = (d & 0xFFFF) << 15;
+            output[i] = _linear(buf, mask, p, frac);
+        }
+        break;
+    }
+
+    Aleph_DelayTap_set_delay(tap, d);
+}
+
+void Aleph_DelayTap_init(t_Aleph_DelayTap *tap, fix16 delay) {
+
+    tap->state = 0;
+
+    Aleph_DelayTap_set_delay(tap, delay);
+}
+
+void Aleph_DelayTap_set_delay(t_Aleph_DelayTap *tap, fix16 delay) {
+
+    int64_t one = (int64_t)1 << 31;
+    int64_t frac;
+
+    tap->delay = delay;
+    tap->offset = delay >> 16;
+    tap->frac = (delay & 0xFFFF) << 15;
+
+    // Allpass delay in [0.5, 1.5), coeff = (1 - frac) / (1 + frac).
+    frac = tap->frac;
+    if (frac < DELAYLINE_HALF) {
+        frac += one;
+    }
+
+    tap->coeff = (fract32)(((one - frac) << 31) / (one + frac));
+}
+
+/*----- Static function implementations ------------------------------*/
+
+static inline uint32_t _allpass_offset(t_Aleph_DelayTap *tap) {
+
+    return tap->frac < DELAYLINE_HALF ? tap->offset - 1 : tap->offset;
+}
+
+// Interpolate from p towards the older sample at p - 1.
+static inline fract32 _linear(fract32 *buf, uint32_t mask, uint32_t p,
+                              fract32 frac) {
+
+    fract32 a = buf[p & mask];
+    fract32 b = buf[(p - 1) & mask];
+
+    return add_fr1x32(a, mult_fr1x32x32(sub_fr1x32(b, a), frac));
+}
+
+static inline fract32 _bspline(fract32 *buf, uint32_t mask, uint32_t p,
+                               fract32 frac) {
+
+    return interp_bspline_fract32(frac, buf[(p + 1) & mask], buf[p & mask],
+                                  buf[(p - 1) & mask], buf[(p - 2) & mask]);
+}
+
+// y[n] = x[p - 1] + coeff * (x[p] - y[n - 1])
+static inline fract32 _allpass(fract32 *buf, uint32_t mask, uint32_t p,
+                               fract32 coeff, fract32 *state) {
+
+    fract32 y = add_fr1x32(
+        buf[(p - 1) & mask],
+        mult_fr1x32x32(coeff, sub_fr1x32(buf[p & mask], *state)));
+
+    *state = y;
+
+    return y;
+}
+
+/*----- End of file --------------------------------------------------*/
@@ -0,0 +1,127 @@
+/*----------------------------------------------------------------------
+
+                     This file is part of Aleph DSP
+
+                https://github.com/bangcorrupt/aleph-dsp
+
+         Aleph DSP is based on monome/aleph and spiricom/LEAF.
+
+                              MIT License
+
+            Aleph dedicated to the public domain by monome.
+
+                LEAF Copyright Jeff Snyder et. al. 2020
+
+                       Copyright bangcorrupt 2024
+
+----------------------------------------------------------------------*/
+/**
+ * @file    aleph_delay_line.h
+ *
+ * @brief   Public API for fractional delay line.
+ *
+ *          Reads are relative to the most recently written sample, so a
+ *          delay of zero returns the last input. Block reads see the block
+ *          most recently written, call write_block before read_block. In a
+ *          feedback loop read first, the effective delay is then delay plus
+ *          block size.
+ */
+
+#ifndef ALEPH_DELAY_LINE_H
+#define ALEPH_DELAY_LINE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*----- Includes -----------------------------------------------------*/
+
+#include "aleph.h"
+
+#include "aleph_interpolate.h"
+
+/*----- Macros -------------------------------------------------------*/
+
+/*----- Typedefs -----------------------------------------------------*/
+
+typedef enum {
+    ALEPH_DELAYLINE_INTERP_NONE,
+    ALEPH_DELAYLINE_INTERP_LINEAR,
+    ALEPH_DELAYLINE_INTERP_BSPLINE,
+    ALEPH_DELAYLINE_INTERP_ALLPASS,
+} e_Aleph_DelayLine_interp;
+
+// Read position, shared by any number of taps on one delay line.
+typedef struct {
+    fix16 delay;
+    uint32_t offset;
+    fract32 frac;
+    fract32 coeff;
+    fract32 state;
+} t_Aleph_DelayTap;
+
+typedef struct {
+    Mempool mempool;
+    fract32 *buffer;
+    uint32_t size;
+    uint32_t mask;
+    uint32_t write;
+    e_Aleph_DelayLine_interp interp;
+} t_Aleph_DelayLine;
+
+typedef t_Aleph_DelayLine *Aleph_DelayLine;
+
+/*----- Extern variable declarations ---------------------------------*/
+
+/*----- Extern function prototypes -----------------------------------*/
+
+// Size is rounded up to a power of two.
+void Aleph_DelayLine_init(Aleph_DelayLine *const delay, uint32_t size,
+                          t_Aleph *const aleph);
+void Aleph_DelayLine_init_to_pool(Aleph_DelayLine *const delay, uint32_t size,
+                                  Mempool *const mempool);
+void Aleph_DelayLine_free(Aleph_DelayLine *const delay);
+
+void Aleph_DelayLine_clear(Aleph_DelayLine *const delay);
+
+void Aleph_DelayLine_set_interp(Aleph_DelayLine *const delay,
+                                e_Aleph_DelayLine_interp interp);
+
+void Aleph_DelayLine_write(Aleph_DelayLine *const delay, fract32 input);
+void Aleph_DelayLine_write_block(Aleph_DelayLine *const delay, fract32 *input,
+                                 size_t size);
+
+fract32 Aleph_DelayLine_read(Aleph_DelayLine *const delay,
+                             t_Aleph_DelayTap *tap);
+void Aleph_DelayLine_read_block(Aleph_DelayLine *const delay,
+                                t_Aleph_DelayTap *tap, fract32 *output,
+                                size_t size);
+
+// Sum of taps scaled by gain.
+void Aleph_DelayLine_read_block_taps(Aleph_DelayLine *const delay,
+                                     t_Aleph_DelayTap *taps, fract32 *gains,
+                                     uint8_t num_taps, fract32 *output,
+                                     size_t size);
+
+// Modulated read, delay ramps in fix16 samples over the block.
+// Allpass interpolation falls back to linear.
+void Aleph_DelayLine_read_block_ramp(Aleph_DelayLine *const delay,
+                                     t_Aleph_DelayTap *tap,
+                                     t_Aleph_Ramp *ramp, fract32 *output,
+                                     size_t size);
+
+// Taps live in caller storage, init clears the allpass state.
+void Aleph_DelayTap_init(t_Aleph_DelayTap *tap, fix16 delay);
+
+// Delay in fix16 samples, must be less than the delay line size.
+// B-spline and allpass interpolation need at least one sample of delay.
+// B-spline also reads two samples past the integer delay, so the delay
+// must be less than size - 2.
+void Aleph_DelayTap_set_delay(t_Aleph_DelayTap *tap, fix16 delay);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+/*----- End of file --------------------------------------------------*/
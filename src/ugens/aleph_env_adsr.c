@@ -33,12 +33,29 @@
 
 /*----- Typedefs -----------------------------------------------------*/
 
+#ifdef __bfin__
+// Two fract16 lanes in one register.
+typedef short v2fr16 __attribute__((vector_size(4), may_alias));
+#endif
+
 /*----- Static variable definitions ----------------------------------*/
 
 /*----- Extern variable definitions ----------------------------------*/
 
 /*----- Static function prototypes -----------------------------------*/
 
+static inline fract32 _env_next(uint8_t *state, fract32 *out,
+                                fract32 overshoot, fract32 attack,
+                                fract32 decay, fract32 sustain,
+                                fract32 release);
+static inline fract16 _env_16_next(uint8_t *state, fract16 *out,
+                                   fract16 overshoot, fract16 attack,
+                                   fract16 decay, fract16 sustain,
+                                   fract16 release);
+static void _bank_update(t_Aleph_EnvADSRBank *eb);
+static inline void _bank_ramp(t_Aleph_EnvADSRBank *eb);
+static fract16 _bank_ratio(fract32 coeff);
+
 /*----- Extern function implementations ------------------------------*/
 
 void Aleph_EnvADSR_init(Aleph_EnvADSR *const envelope, t_Aleph *const aleph) {
@@ -72,6 +89,22 @@ void Aleph_EnvADSR_free(Aleph_EnvADSR *const envelope) {
     mpool_free((char *)env, env->mempool);
 }
 
+void Aleph_EnvADSR_reset(Aleph_EnvADSR *const envelope) {
+
+    t_Aleph_EnvADSR *env = *envelope;
+
+    env->env_state = ADSR_RELEASE;
+    env->env_out = 0;
+}
+
+bool Aleph_EnvADSR_is_idle(Aleph_EnvADSR *const envelope) {
+
+    t_Aleph_EnvADSR *env = *envelope;
+
+    return env->env_state == ADSR_RELEASE &&
+           env->env_out < ALEPH_ENV_ADSR_IDLE_THRESHOLD;
+}
+
 void Aleph_EnvADSR_set_gate(Aleph_EnvADSR *const envelope, bool gate) {
 
     t_Aleph_EnvADSR *env = *envelope;
@@ -88,25 +121,56 @@ fract32 Aleph_EnvADSR_next(Aleph_EnvADSR *envelope) {
 
     t_Aleph_EnvADSR *env = *envelope;
 
-    switch (env->env_state) {
+    uint8_t state = env->env_state;
 
-    case ADSR_ATTACK:
-        normalised_log_slew(&(env->env_out), FR32_MAX, env->attack);
-        if (env->env_out > FR32_MAX - env->overshoot) {
-            env->env_state = ADSR_DECAY;
+    _env_next(&state, &env->env_out, env->overshoot, env->attack, env->decay,
+              env->sustain, env->release);
+
+    env->env_state = state;
+
+    return env->env_out;
+}
+
+// Same output as calling Aleph_EnvADSR_next() size times.
+void Aleph_EnvADSR_next_block(Aleph_EnvADSR *const envelope, fract32 *output,
+                              size_t size) {
+
+    t_Aleph_EnvADSR *env = *envelope;
+
+    fract32 out = env->env_out;
+    fract32 target;
+    fract32 speed;
+
+    int i = 0;
+
+    // Attack ends part way through the block when threshold is crossed.
+    if (env->env_state == ADSR_ATTACK) {
+
+        while (i < size) {
+
+            normalised_log_slew(&out, FR32_MAX, env->attack);
+            output[i++] = out;
+
+            if (out > FR32_MAX - env->overshoot) {
+                env->env_state = ADSR_DECAY;
+                break;
+            }
         }
-        break;
+    }
 
-    case ADSR_DECAY:
-        normalised_log_slew(&(env->env_out), env->sustain, env->decay);
-        break;
+    if (env->env_state == ADSR_DECAY) {
+        target = env->sustain;
+        speed = env->decay;
 
-    case ADSR_RELEASE:
-        normalised_log_slew(&(env->env_out), 0, env->release);
-        break;
+    } else {
+        target = 0;
+        speed = env->release;
     }
 
-    return env->env_out;
+    // Sustain or silence is a constant fill once converged.
+    normalised_log_slew_block(&out, target, speed, &output[i], size - i);
+
+    env->env_out = out;
 }
 
 void Aleph_EnvADSR_set_attack(Aleph_EnvADSR *const envelope, fract32 attack) {
@@ -162,6 +226,13 @@ void Aleph_EnvADSR_16_init_to_pool(Aleph_EnvADSR_16 *const envelope,
     env->release = SLEW_1S_16;
 }
 
+void Aleph_EnvADSR_16_free(Aleph_EnvADSR_16 *const envelope) {
+
+    t_Aleph_EnvADSR_16 *env = *envelope;
+
+    mpool_free((char *)env, env->mempool);
+}
+
 void Aleph_EnvADSR_16_set_gate(Aleph_EnvADSR_16 *const envelope, bool gate) {
 
     t_Aleph_EnvADSR_16 *env = *envelope;
@@ -178,23 +249,12 @@ fract16 Aleph_EnvADSR_16_next(Aleph_EnvADSR_16 *envelope) {
 
     t_Aleph_EnvADSR_16 *env = *envelope;
 
-    switch (env->env_state) {
+    uint8_t state = env->env_state;
 
-    case ADSR_ATTACK:
-        normalised_log_slew_16(&(env->env_out), FR16_MAX, env->attack);
-        if (env->env_out > FR16_MAX - env->overshoot) {
-            env->env_state = ADSR_DECAY;
-        }
-        break;
+    _env_16_next(&state, &env->env_out, env->overshoot, env->attack,
+                 env->decay, env->sustain, env->release);
 
-    case ADSR_DECAY:
-        normalised_log_slew_16(&(env->env_out), env->sustain, env->decay);
-        break;
-
-    case ADSR_RELEASE:
-        normalised_log_slew_16(&(env->env_out), 0, env->release);
-        break;
-    }
+    env->env_state = state;
 
     return env->env_out;
 }
@@ -231,6 +291,295 @@ void Aleph_EnvADSR_16_set_release(Aleph_EnvADSR_16 *const envelope,
     env->release = release;
 }
 
+void Aleph_EnvADSRBank_init(Aleph_EnvADSRBank *const bank, uint8_t num_envs,
+                            t_Aleph *const aleph) {
+
+    Aleph_EnvADSRBank_init_to_pool(bank, num_envs, &aleph->mempool);
+}
+
+void Aleph_EnvADSRBank_init_to_pool(Aleph_EnvADSRBank *const bank,
+                                    uint8_t num_envs, Mempool *const mempool) {
+
+    t_Mempool *mp = *mempool;
+
+    t_Aleph_EnvADSRBank *eb = *bank = (t_Aleph_EnvADSRBank *)mpool_alloc(
+        sizeof(t_Aleph_EnvADSRBank), mp);
+
+    eb->mempool = mp;
+
+    if (num_envs > ALEPH_ENV_ADSR_BANK_MAX) {
+        num_envs = ALEPH_ENV_ADSR_BANK_MAX;
+    }
+
+    eb->num_envs = num_envs;
+    eb->count = 0;
+    eb->overshoot = FR16_MAX / 10;
+
+    int i;
+    for (i = 0; i < ALEPH_ENV_ADSR_BANK_MAX; i++) {
+        eb->env_state[i] = ADSR_RELEASE;
+        eb->env_out[i] = 0;
+        eb->env_frac[i] = 0;
+        eb->inc[i] = 0;
+        eb->attack[i] = _bank_ratio(SLEW_10MS);
+        eb->decay[i] = _bank_ratio(SLEW_100MS);
+        eb->sustain[i] = FR16_MAX >> 2;
+        eb->release[i] = _bank_ratio(SLEW_1S);
+    }
+}
+
+void Aleph_EnvADSRBank_free(Aleph_EnvADSRBank *const bank) {
+
+    t_Aleph_EnvADSRBank *eb = *bank;
+
+    mpool_free((char *)eb, eb->mempool);
+}
+
+void Aleph_EnvADSRBank_reset(Aleph_EnvADSRBank *const bank) {
+
+    t_Aleph_EnvADSRBank *eb = *bank;
+
+    int i;
+    for (i = 0; i < eb->num_envs; i++) {
+        eb->env_state[i] = ADSR_RELEASE;
+        eb->env_out[i] = 0;
+        eb->env_frac[i] = 0;
+        eb->inc[i] = 0;
+    }
+}
+
+bool Aleph_EnvADSRBank_is_idle(Aleph_EnvADSRBank *const bank) {
+
+    t_Aleph_EnvADSRBank *eb = *bank;
+
+    int i;
+    for (i = 0; i < eb->num_envs; i++) {
+        if (eb->env_state[i] != ADSR_RELEASE ||
+            eb->env_out[i] >= ALEPH_ENV_ADSR_IDLE_THRESHOLD >> 16) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Aleph_EnvADSRBank_next(Aleph_EnvADSRBank *const bank, fract16 *output) {
+
+    t_Aleph_EnvADSRBank *eb = *bank;
+
+    if (eb->count == 0) {
+        _bank_update(eb);
+        eb->count = ALEPH_ENV_ADSR_BANK_RATE;
+    }
+
+    eb->count--;
+
+    _bank_ramp(eb);
+
+    int i;
+    for (i = 0; i < eb->num_envs; i++) {
+        output[i] = eb->env_out[i];
+    }
+}
+
+void Aleph_EnvADSRBank_set_gate(Aleph_EnvADSRBank *const bank, bool gate) {
+
+    t_Aleph_EnvADSRBank *eb = *bank;
+
+    int i;
+    for (i = 0; i < eb->num_envs; i++) {
+        eb->env_state[i] = gate ? ADSR_ATTACK : ADSR_RELEASE;
+    }
+
+    // Start the new segment on the next sample.
+    eb->count = 0;
+}
+
+void Aleph_EnvADSRBank_set_attack(Aleph_EnvADSRBank *const bank, uint8_t index,
+                                  fract32 attack) {
+
+    t_Aleph_EnvADSRBank *eb = *bank;
+
+    eb->attack[index] = _bank_ratio(attack);
+}
+
+void Aleph_EnvADSRBank_set_decay(Aleph_EnvADSRBank *const bank, uint8_t index,
+                                 fract32 decay) {
+
+    t_Aleph_EnvADSRBank *eb = *bank;
+
+    eb->decay[index] = _bank_ratio(decay);
+}
+
+void Aleph_EnvADSRBank_set_sustain(Aleph_EnvADSRBank *const bank, uint8_t index,
+                                   fract32 sustain) {
+
+    t_Aleph_EnvADSRBank *eb = *bank;
+
+    eb->sustain[index] = trunc_fr1x32(sustain);
+}
+
+void Aleph_EnvADSRBank_set_release(Aleph_EnvADSRBank *const bank, uint8_t index,
+                                   fract32 release) {
+
+    t_Aleph_EnvADSRBank *eb = *bank;
+
+    eb->release[index] = _bank_ratio(release);
+}
+
 /*----- Static function implementations ------------------------------*/
 
+static inline fract32 _env_next(uint8_t *state, fract32 *out,
+                                fract32 overshoot, fract32 attack,
+                                fract32 decay, fract32 sustain,
+                                fract32 release) {
+
+    switch (*state) {
+
+    case ADSR_ATTACK:
+        normalised_log_slew(out, FR32_MAX, attack);
+        if (*out > FR32_MAX - overshoot) {
+            *state = ADSR_DECAY;
+        }
+        break;
+
+    case ADSR_DECAY:
+        normalised_log_slew(out, sustain, decay);
+        break;
+
+    case ADSR_RELEASE:
+        normalised_log_slew(out, 0, release);
+        break;
+    }
+
+    return *out;
+}
+
+static inline fract16 _env_16_next(uint8_t *state, fract16 *out,
+                                   fract16 overshoot, fract16 attack,
+                                   fract16 decay, fract16 sustain,
+                                   fract16 release) {
+
+    switch (*state) {
+
+    case ADSR_ATTACK:
+        normalised_log_slew_16(out, FR16_MAX, attack);
+        if (*out > FR16_MAX - overshoot) {
+            *state = ADSR_DECAY;
+        }
+        break;
+
+    case ADSR_DECAY:
+        normalised_log_slew_16(out, sustain, decay);
+        break;
+
+    case ADSR_RELEASE:
+        normalised_log_slew_16(out, 0, release);
+        break;
+    }
+
+    return *out;
+}
+
+// Slew each lane's full level once per update and ramp the 16-bit output
+// towards it over the next ALEPH_ENV_ADSR_BANK_RATE samples.
+static void _bank_update(t_Aleph_EnvADSRBank *eb) {
+
+    fract32 level;
+    fract32 target;
+    fract16 ratio;
+    int32_t step;
+    int32_t diff;
+    int32_t inc;
+
+    int i;
+    for (i = 0; i < eb->num_envs; i++) {
+
+        // Ramp has landed on the high half of the last level.
+        level = ((fract32)eb->env_out[i] << 16) | eb->env_frac[i];
+
+        if (eb->env_state[i] == ADSR_ATTACK &&
+            eb->env_out[i] > FR16_MAX - eb->overshoot) {
+            eb->env_state[i] = ADSR_DECAY;
+        }
+
+        switch (eb->env_state[i]) {
+
+        case ADSR_ATTACK:
+            target = FR32_MAX;
+            ratio = eb->attack[i];
+            break;
+
+        case ADSR_DECAY:
+            target = (fract32)eb->sustain[i] << 16;
+            ratio = eb->decay[i];
+            break;
+
+        default:
+            target = 0;
+            ratio = eb->release[i];
+            break;
+        }
+
+        // Floor moves down at least one LSB, move up at least one as well.
+        step = (int32_t)(((int64_t)target - level) * ratio >> 15);
+
+        if (step == 0 && target > level) {
+            step = 1;
+        }
+
+        level += step;
+
+        eb->env_frac[i] = (uint16_t)level;
+
+        // Whole LSB per sample, the remainder is applied now.
+        diff = (level >> 16) - eb->env_out[i];
+        inc = diff / ALEPH_ENV_ADSR_BANK_RATE;
+
+        eb->env_out[i] += diff - inc * ALEPH_ENV_ADSR_BANK_RATE;
+        eb->inc[i] = inc;
+    }
+}
+
+// Advance every lane by its increment, two lanes per packed add.
+static inline void _bank_ramp(t_Aleph_EnvADSRBank *eb) {
+
+    int i;
+
+#ifdef __bfin__
+    v2fr16 *out = (v2fr16 *)eb->env_out;
+    v2fr16 *inc = (v2fr16 *)eb->inc;
+
+    for (i = 0; i < (eb->num_envs + 1) >> 1; i++) {
+        out[i] = __builtin_bfin_add_fr2x16(out[i], inc[i]);
+    }
+#else
+    for (i = 0; i < eb->num_envs; i++) {
+        eb->env_out[i] = add_fr1x16(eb->env_out[i], eb->inc[i]);
+    }
+#endif
+}
+
+// Convert a per sample SLEW_* coefficient to the fraction of the remaining
+// distance covered in one update, 1 - coeff^ALEPH_ENV_ADSR_BANK_RATE.
+static fract16 _bank_ratio(fract32 coeff) {
+
+    int32_t ratio;
+
+    int i;
+    for (i = 0; i < ALEPH_ENV_ADSR_BANK_RATE_BITS; i++) {
+        coeff = mult_fr1x32x32(coeff, coeff);
+    }
+
+    ratio = (int32_t)(((int64_t)FR32_MAX - coeff + (1 << 15)) >> 16);
+
+    if (ratio < 1) {
+        ratio = 1;
+    } else if (ratio > FR16_MAX) {
+        ratio = FR16_MAX;
+    }
+
+    return (fract16)ratio;
+}
+
 /*----- End of file --------------------------------------------------*/
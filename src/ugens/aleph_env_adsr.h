@@ -35,6 +35,15 @@ extern "C" {
 
 /*----- Macros -------------------------------------------------------*/
 
+// Released envelope below this level is treated as silent, about -90 dB.
+#define ALEPH_ENV_ADSR_IDLE_THRESHOLD (1 << 16)
+
+#define ALEPH_ENV_ADSR_BANK_MAX (8)
+
+// Bank levels are recalculated once every ALEPH_ENV_ADSR_BANK_RATE samples.
+#define ALEPH_ENV_ADSR_BANK_RATE_BITS (3)
+#define ALEPH_ENV_ADSR_BANK_RATE (1 << ALEPH_ENV_ADSR_BANK_RATE_BITS)
+
 /*----- Typedefs -----------------------------------------------------*/
 
 typedef enum {
@@ -69,6 +78,29 @@ typedef struct {
 
 typedef t_Aleph_EnvADSR_16 *Aleph_EnvADSR_16;
 
+// Structure of arrays, one lane per envelope. Every sample the lanes ramp
+// by `inc`, two lanes per packed 16-bit add. Every ALEPH_ENV_ADSR_BANK_RATE
+// samples the level, `env_out` with `env_frac` below it, is slewed with a
+// coefficient scaled to that rate, so slow segments keep their resolution.
+typedef struct {
+    Mempool mempool;
+    // Accessed as packed pairs, keep 4-byte aligned after the pointer.
+    fract16 env_out[ALEPH_ENV_ADSR_BANK_MAX];
+    fract16 inc[ALEPH_ENV_ADSR_BANK_MAX];
+    uint16_t env_frac[ALEPH_ENV_ADSR_BANK_MAX]; // low half of the level
+    uint8_t num_envs;
+    uint8_t count; // samples left before the next update
+    uint8_t env_state[ALEPH_ENV_ADSR_BANK_MAX];
+    fract16 overshoot;
+    // Fraction of the remaining distance covered per update.
+    fract16 attack[ALEPH_ENV_ADSR_BANK_MAX];
+    fract16 decay[ALEPH_ENV_ADSR_BANK_MAX];
+    fract16 sustain[ALEPH_ENV_ADSR_BANK_MAX];
+    fract16 release[ALEPH_ENV_ADSR_BANK_MAX];
+} t_Aleph_EnvADSRBank;
+
+typedef t_Aleph_EnvADSRBank *Aleph_EnvADSRBank;
+
 /*----- Extern variable declarations ---------------------------------*/
 
 /*----- Extern function prototypes -----------------------------------*/
@@ -78,7 +110,15 @@ void Aleph_EnvADSR_init_to_pool(Aleph_EnvADSR *const envelope,
                                 Mempool *const mempool);
 void Aleph_EnvADSR_free(Aleph_EnvADSR *const envelope);
 
+// Snap to zero in release state.
+void Aleph_EnvADSR_reset(Aleph_EnvADSR *const envelope);
+
+// True when released and below ALEPH_ENV_ADSR_IDLE_THRESHOLD.
+bool Aleph_EnvADSR_is_idle(Aleph_EnvADSR *const envelope);
+
 fract32 Aleph_EnvADSR_next(Aleph_EnvADSR *const envelope);
+void Aleph_EnvADSR_next_block(Aleph_EnvADSR *const envelope, fract32 *output,
+                              size_t size);
 
 void Aleph_EnvADSR_set_gate(Aleph_EnvADSR *const envelope, bool gate);
 void Aleph_EnvADSR_set_attack(Aleph_EnvADSR *const envelope, fract32 attack);
@@ -86,12 +126,17 @@ void Aleph_EnvADSR_set_decay(Aleph_EnvADSR *const envelope, fract32 decay);
 void Aleph_EnvADSR_set_sustain(Aleph_EnvADSR *const envelope, fract32 sustain);
 void Aleph_EnvADSR_set_release(Aleph_EnvADSR *const envelope, fract32 release);
 
+// Rates are on the SLEW_*_16 scale, FR16_MAX - k moves k / 32768 of the
+// remaining distance per sample, but never less than one LSB. Segments last
+// at most 32768 samples, about 0.7 s at 48 kHz, and below k = 8 (slower than
+// about 85 ms) they bend towards a linear ramp. Use Aleph_EnvADSR or
+// Aleph_EnvADSRBank for slower envelopes.
 void Aleph_EnvADSR_16_init(Aleph_EnvADSR_16 *const envelope,
                            t_Aleph *const aleph);
 void Aleph_EnvADSR_16_init_to_pool(Aleph_EnvADSR_16 *const envelope,
                                    Mempool *const mempool);
 
-void Aleph_EnvADSR_16_free(Aleph_EnvADSR *const envelope);
+void Aleph_EnvADSR_16_free(Aleph_EnvADSR_16 *const envelope);
 
 fract16 Aleph_EnvADSR_16_next(Aleph_EnvADSR_16 *const envelope);
 
@@ -105,6 +150,35 @@ void Aleph_EnvADSR_16_set_sustain(Aleph_EnvADSR_16 *const envelope,
 void Aleph_EnvADSR_16_set_release(Aleph_EnvADSR_16 *const envelope,
                                   fract16 release);
 
+void Aleph_EnvADSRBank_init(Aleph_EnvADSRBank *const bank, uint8_t num_envs,
+                            t_Aleph *const aleph);
+void Aleph_EnvADSRBank_init_to_pool(Aleph_EnvADSRBank *const bank,
+                                    uint8_t num_envs, Mempool *const mempool);
+void Aleph_EnvADSRBank_free(Aleph_EnvADSRBank *const bank);
+
+void Aleph_EnvADSRBank_reset(Aleph_EnvADSRBank *const bank);
+
+// True when every envelope is released and below threshold.
+bool Aleph_EnvADSRBank_is_idle(Aleph_EnvADSRBank *const bank);
+
+// Advance every envelope by one sample, output holds num_envs values.
+void Aleph_EnvADSRBank_next(Aleph_EnvADSRBank *const bank, fract16 *output);
+
+void Aleph_EnvADSRBank_set_gate(Aleph_EnvADSRBank *const bank, bool gate);
+
+// Rates take fract32 coefficients on the SLEW_* scale. Time constants up to
+// ALEPH_ENV_ADSR_BANK_RATE * 32768 samples, about 5.5 s at 48 kHz, are
+// resolved, SLEW_1S to within about 2 percent. Segments shorter than one
+// update become a linear ramp.
+void Aleph_EnvADSRBank_set_attack(Aleph_EnvADSRBank *const bank, uint8_t index,
+                                  fract32 attack);
+void Aleph_EnvADSRBank_set_decay(Aleph_EnvADSRBank *const bank, uint8_t index,
+                                 fract32 decay);
+void Aleph_EnvADSRBank_set_sustain(Aleph_EnvADSRBank *const bank, uint8_t index,
+                                   fract32 sustain);
+void Aleph_EnvADSRBank_set_release(Aleph_EnvADSRBank *const bank, uint8_t index,
+                                   fract32 release);
+
 #ifdef __cplusplus
 }
 #endif
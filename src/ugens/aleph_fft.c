@@ -0,0 +1,480 @@
+/*----------------------------------------------------------------------
+
+                     This file is part of Aleph DSP
+
+                https://github.com/bangcorrupt/aleph-dsp
+
+         Aleph DSP is based on monome/aleph and spiricom/LEAF.
+
+                              MIT License
+
+            Aleph dedicated to the public domain by monome.
+
+                LEAF Copyright Jeff Snyder et. al. 2020
+
+                       Copyright bangcorrupt 2024
+
+----------------------------------------------------------------------*/
+/**
+ * @file    aleph_fft.c
+ *
+ * @brief   Fixed point FFT.
+ *
+ *          Radix-2 decimation in time. A radix-2 butterfly grows each
+ *          component by at most 1 + sqrt(2), so before each stage the
+ *          block is shifted right until its peak is below 1 / 4. The real
+ *          split and merge passes grow a component by up to 2 + 2 sqrt(2)
+ *          and are pre-shifted until the peak is below 1 / 8.
+ */
+
+/*----- Includes -----------------------------------------------------*/
+
+#include "aleph.h"
+
+#include "aleph_fft.h"
+#include "aleph_sine_table.h"
+
+/*----- Macros -------------------------------------------------------*/
+
+// Peak below these survives a butterfly without saturating.
+#define FFT_HEADROOM_32 (1 << 29)
+#define FFT_HEADROOM_16 (1 << 13)
+
+// Peak below this survives a real split or merge without saturating.
+#define FFT_SPLIT_HEADROOM_32 (1 << 28)
+
+/*----- Typedefs -----------------------------------------------------*/
+
+/*----- Static variable definitions ----------------------------------*/
+
+/*----- Extern variable definitions ----------------------------------*/
+
+/*----- Static function prototypes -----------------------------------*/
+
+static int _fft(t_Aleph_FFT *ft, fract32 *data, bool inverse);
+static int _fft_16(t_Aleph_FFT *ft, fract16 *data, bool inverse);
+static fract32 _peak(fract32 *data, int count);
+static inline int _headroom_shift(fract32 peak, fract32 headroom);
+
+/*----- Extern function implementations ------------------------------*/
+
+void Aleph_FFT_init(Aleph_FFT *const fft, uint8_t log2_size,
+                    t_Aleph *const aleph) {
+
+    Aleph_FFT_init_to_pool(fft, log2_size, &aleph->mempool);
+}
+
+void Aleph_FFT_init_to_pool(Aleph_FFT *const fft, uint8_t log2_size,
+                            Mempool *const mempool) {
+
+    Aleph_FFT_init_to_pools(fft, log2_size, mempool, mempool);
+}
+
+void Aleph_FFT_init_to_pools(Aleph_FFT *const fft, uint8_t log2_size,
+                             Mempool *const mempool,
+                             Mempool *const table_mempool) {
+
+    t_Mempool *mp = *mempool;
+    t_Mempool *tp = *table_mempool;
+
+    t_Aleph_FFT *ft = *fft =
+        (t_Aleph_FFT *)mpool_alloc(sizeof(t_Aleph_FFT), mp);
+
+    ft->mempool = mp;
+    ft->table_mempool = tp;
+
+    if (log2_size < ALEPH_FFT_MIN_LOG2_SIZE) {
+        log2_size = ALEPH_FFT_MIN_LOG2_SIZE;
+    } else if (log2_size > ALEPH_FFT_MAX_LOG2_SIZE) {
+        log2_size = ALEPH_FFT_MAX_LOG2_SIZE;
+    }
+
+    ft->log2_size = log2_size;
+    ft->size = 1 << log2_size;
+
+    ft->twiddles =
+        (fract32 *)mpool_alloc(sizeof(fract32) * ft->size, tp);
+
+    ft->real_twiddles =
+        (fract32 *)mpool_alloc(sizeof(fract32) * (ft->size + 2), tp);
+
+    ft->bit_reverse =
+        (uint16_t *)mpool_alloc(sizeof(uint16_t) * ft->size, tp);
+
+    int32_t phase;
+    uint16_t rev;
+
+    int i, b;
+    for (i = 0; i < ft->size / 2; i++) {
+
+        // 2 pi i / size, full cycle wraps at 2^32.
+        phase = (int32_t)((uint32_t)i << (32 - log2_size));
+
+        ft->twiddles[2 * i] = cosine_lookup(phase);
+        ft->twiddles[2 * i + 1] = sine_lookup(phase);
+    }
+
+    for (i = 0; i <= ft->size / 2; i++) {
+
+        // pi i / size
+        phase = (int32_t)((uint32_t)i << (31 - log2_size));
+
+        ft->real_twiddles[2 * i] = cosine_lookup(phase);
+        ft->real_twiddles[2 * i + 1] = sine_lookup(phase);
+    }
+
+    for (i = 0; i < ft->size; i++) {
+
+        rev = 0;
+        for (b = 0; b < log2_size; b++) {
+            rev = (rev << 1) | ((i >> b) & 1);
+        }
+
+        ft->bit_reverse[i] = rev;
+    }
+}
+
+void Aleph_FFT_free(Aleph_FFT *const fft) {
+
+    t_Aleph_FFT *ft = *fft;
+
+    mpool_free((char *)ft->bit_reverse, ft->table_mempool);
+    mpool_free((char *)ft->real_twiddles, ft->table_mempool);
+    mpool_free((char *)ft->twiddles, ft->table_mempool);
+    mpool_free((char *)ft, ft->mempool);
+}
+
+int Aleph_FFT_complex_forward(Aleph_FFT *const fft, fract32 *data) {
+
+    t_Aleph_FFT *ft = *fft;
+
+    return _fft(ft, data, false);
+}
+
+int Aleph_FFT_complex_inverse(Aleph_FFT *const fft, fract32 *data) {
+
+    t_Aleph_FFT *ft = *fft;
+
+    return _fft(ft, data, true);
+}
+
+int Aleph_FFT_complex_forward_16(Aleph_FFT *const fft, fract16 *data) {
+
+    t_Aleph_FFT *ft = *fft;
+
+    return _fft_16(ft, data, false);
+}
+
+int Aleph_FFT_complex_inverse_16(Aleph_FFT *const fft, fract16 *data) {
+
+    t_Aleph_FFT *ft = *fft;
+
+    return _fft_16(ft, data, true);
+}
+
+// Even samples as real part, odd as imaginary, then split the spectrum.
+int Aleph_FFT_real_forward(Aleph_FFT *const fft, fract32 *data) {
+
+    t_Aleph_FFT *ft = *fft;
+
+    int n = ft->size;
+    int exponent = _fft(ft, data, false);
+    int shift;
+
+    fract32 *tw = ft->real_twiddles;
+    fract32 zr, zi;
+    fract32 ar, ai, br, bi;
+    fract32 er, ei, odd_r, odd_i;
+    fract32 tr, ti;
+    fract32 c, s;
+    int j;
+
+    // The split halves A + conj(B) and A - conj(B), so at least one bit
+    // of the shift is part of the transform.
+    shift = _headroom_shift(_peak(data, 2 * n), FFT_SPLIT_HEADROOM_32);
+    if (shift < 1) {
+        shift = 1;
+    }
+
+    zr = shr_fr1x32(data[0], shift - 1);
+    zi = shr_fr1x32(data[1], shift - 1);
+
+    data[0] = add_fr1x32(zr, zi);
+    data[1] = sub_fr1x32(zr, zi);
+
+    int k;
+    for (k = 1; k <= n / 2; k++) {
+
+        j = n - k;
+
+        ar = shr_fr1x32(data[2 * k], shift);
+        ai = shr_fr1x32(data[2 * k + 1], shift);
+        br = shr_fr1x32(data[2 * j], shift);
+        bi = shr_fr1x32(data[2 * j + 1], shift);
+
+        // Even part (A + conj(B)) / 2, odd part -i(A - conj(B)) / 2.
+        er = add_fr1x32(ar, br);
+        ei = sub_fr1x32(ai, bi);
+        odd_r = add_fr1x32(ai, bi);
+        odd_i = sub_fr1x32(br, ar);
+
+        // Odd part times exp(-i pi k / n).
+        c = tw[2 * k];
+        s = tw[2 * k + 1];
+
+        tr = add_fr1x32(mult_fr1x32x32(odd_r, c), mult_fr1x32x32(odd_i, s));
+        ti = sub_fr1x32(mult_fr1x32x32(odd_i, c), mult_fr1x32x32(odd_r, s));
+
+        data[2 * j] = sub_fr1x32(er, tr);
+        data[2 * j + 1] = sub_fr1x32(ti, ei);
+        data[2 * k] = add_fr1x32(er, tr);
+        data[2 * k + 1] = add_fr1x32(ei, ti);
+    }
+
+    return exponent + shift - 1;
+}
+
+int Aleph_FFT_real_inverse(Aleph_FFT *const fft, fract32 *data) {
+
+    t_Aleph_FFT *ft = *fft;
+
+    int n = ft->size;
+    int shift;
+
+    fract32 *tw = ft->real_twiddles;
+    fract32 x0, xn;
+    fract32 ar, ai, br, bi;
+    fract32 er, ei, dr, di;
+    fract32 fr, fi;
+    fract32 c, s;
+    int j;
+
+    // The merge halves A + conj(B) and A - conj(B), so at least one bit
+    // of the shift is part of the transform.
+    shift = _headroom_shift(_peak(data, 2 * n), FFT_SPLIT_HEADROOM_32);
+    if (shift < 1) {
+        shift = 1;
+    }
+
+    x0 = shr_fr1x32(data[0], shift);
+    xn = shr_fr1x32(data[1], shift);
+
+    data[0] = add_fr1x32(x0, xn);
+    data[1] = sub_fr1x32(x0, xn);
+
+    int k;
+    for (k = 1; k <= n / 2; k++) {
+
+        j = n - k;
+
+        ar = shr_fr1x32(data[2 * k], shift);
+        ai = shr_fr1x32(data[2 * k + 1], shift);
+        br = shr_fr1x32(data[2 * j], shift);
+        bi = shr_fr1x32(data[2 * j + 1], shift);
+
+        // Even part (A + conj(B)) / 2, difference (A - conj(B)) / 2.
+        er = add_fr1x32(ar, br);
+        ei = sub_fr1x32(ai, bi);
+        dr = sub_fr1x32(ar, br);
+        di = add_fr1x32(ai, bi);
+
+        // Odd part, difference times exp(i pi k / n).
+        c = tw[2 * k];
+        s = tw[2 * k + 1];
+
+        fr = sub_fr1x32(mult_fr1x32x32(dr, c), mult_fr1x32x32(di, s));
+        fi = add_fr1x32(mult_fr1x32x32(dr, s), mult_fr1x32x32(di, c));
+
+        data[2 * j] = add_fr1x32(er, fi);
+        data[2 * j + 1] = sub_fr1x32(fr, ei);
+        data[2 * k] = sub_fr1x32(er, fi);
+        data[2 * k + 1] = add_fr1x32(ei, fr);
+    }
+
+    return _fft(ft, data, true) + shift - 1;
+}
+
+/*----- Static function implementations ------------------------------*/
+
+static int _fft(t_Aleph_FFT *ft, fract32 *data, bool inverse) {
+
+    int n = ft->size;
+    int exponent = 0;
+    int shift;
+    int half, step;
+    int a, b, k;
+
+    fract32 *tw = ft->twiddles;
+    fract32 max = 0;
+    fract32 ar, ai, br, bi;
+    fract32 tr, ti;
+    fract32 c, s;
+    fract32 tmp;
+
+    for (a = 0; a < n; a++) {
+
+        b = ft->bit_reverse[a];
+
+        if (a < b) {
+            tmp = data[2 * a];
+            data[2 * a] = data[2 * b];
+            data[2 * b] = tmp;
+
+            tmp = data[2 * a + 1];
+            data[2 * a + 1] = data[2 * b + 1];
+            data[2 * b + 1] = tmp;
+        }
+
+        max |= abs_fr1x32(data[2 * a]) | abs_fr1x32(data[2 * a + 1]);
+    }
+
+    for (half = 1, step = n >> 1; half < n; half <<= 1, step >>= 1) {
+
+        // Scale as the stage is computed, no extra pass over the data.
+        shift = _headroom_shift(max, FFT_HEADROOM_32);
+        exponent += shift;
+
+        max = 0;
+
+        for (k = 0; k < half; k++) {
+
+            c = tw[2 * k * step];
+            s = inverse ? -tw[2 * k * step + 1] : tw[2 * k * step + 1];
+
+            for (a = k; a < n; a += 2 * half) {
+
+                b = a + half;
+
+                ar = shr_fr1x32(data[2 * a], shift);
+                ai = shr_fr1x32(data[2 * a + 1], shift);
+                br = shr_fr1x32(data[2 * b], shift);
+                bi = shr_fr1x32(data[2 * b + 1], shift);
+
+                // First twiddle is unity.
+                if (k == 0) {
+                    tr = br;
+                    ti = bi;
+                } else {
+                    tr = add_fr1x32(mult_fr1x32x32(br, c),
+                                    mult_fr1x32x32(bi, s));
+                    ti = sub_fr1x32(mult_fr1x32x32(bi, c),
+                                    mult_fr1x32x32(br, s));
+                }
+
+                data[2 * a] = add_fr1x32(ar, tr);
+                data[2 * a + 1] = add_fr1x32(ai, ti);
+                data[2 * b] = sub_fr1x32(ar, tr);
+                data[2 * b + 1] = sub_fr1x32(ai, ti);
+
+                max |= abs_fr1x32(data[2 * a]) | abs_fr1x32(data[2 * a + 1]) |
+                       abs_fr1x32(data[2 * b]) | abs_fr1x32(data[2 * b + 1]);
+            }
+        }
+    }
+
+    return exponent;
+}
+
+static int _fft_16(t_Aleph_FFT *ft, fract16 *data, bool inverse) {
+
+    int n = ft->size;
+    int exponent = 0;
+    int shift;
+    int half, step;
+    int a, b, k;
+
+    fract32 *tw = ft->twiddles;
+    fract16 max = 0;
+    fract16 ar, ai, br, bi;
+    fract16 tr, ti;
+    fract16 c, s;
+    fract16 tmp;
+
+    for (a = 0; a < n; a++) {
+
+        b = ft->bit_reverse[a];
+
+        if (a < b) {
+            tmp = data[2 * a];
+            data[2 * a] = data[2 * b];
+            data[2 * b] = tmp;
+
+            tmp = data[2 * a + 1];
+            data[2 * a + 1] = data[2 * b + 1];
+            data[2 * b + 1] = tmp;
+        }
+
+        max |= abs_fr1x16(data[2 * a]) | abs_fr1x16(data[2 * a + 1]);
+    }
+
+    for (half = 1, step = n >> 1; half < n; half <<= 1, step >>= 1) {
+
+        shift = _headroom_shift(max, FFT_HEADROOM_16);
+        exponent += shift;
+
+        max = 0;
+
+        for (k = 0; k < half; k++) {
+
+            c = trunc_fr1x32(tw[2 * k * step]);
+            s = trunc_fr1x32(tw[2 * k * step + 1]);
+            s = inverse ? -s : s;
+
+            for (a = k; a < n; a += 2 * half) {
+
+                b = a + half;
+
+                ar = shr_fr1x16(data[2 * a], shift);
+                ai = shr_fr1x16(data[2 * a + 1], shift);
+                br = shr_fr1x16(data[2 * b], shift);
+                bi = shr_fr1x16(data[2 * b + 1], shift);
+
+                if (k == 0) {
+                    tr = br;
+                    ti = bi;
+                } else {
+                    tr = add_fr1x16(multr_fr1x16(br, c), multr_fr1x16(bi, s));
+                    ti = sub_fr1x16(multr_fr1x16(bi, c), multr_fr1x16(br, s));
+                }
+
+                data[2 * a] = add_fr1x16(ar, tr);
+                data[2 * a + 1] = add_fr1x16(ai, ti);
+                data[2 * b] = sub_fr1x16(ar, tr);
+                data[2 * b + 1] = sub_fr1x16(ai, ti);
+
+                max |= abs_fr1x16(data[2 * a]) | abs_fr1x16(data[2 * a + 1]) |
+                       abs_fr1x16(data[2 * b]) | abs_fr1x16(data[2 * b + 1]);
+            }
+        }
+    }
+
+    return exponent;
+}
+
+// OR of magnitudes, at least the peak and below twice the peak.
+static fract32 _peak(fract32 *data, int count) {
+
+    fract32 max = 0;
+
+    int i;
+    for (i = 0; i < count; i++) {
+        max |= abs_fr1x32(data[i]);
+    }
+
+    return max;
+}
+
+// Smallest right shift that brings peak below headroom.
+static inline int _headroom_shift(fract32 peak, fract32 headroom) {
+
+    int shift = 0;
+
+    while (peak >= headroom) {
+        peak >>= 1;
+        shift++;
+    }
+
+    return shift;
+}
+
+/*----- End of file --------------------------------------------------*/
@@ -0,0 +1,96 @@
+/*----------------------------------------------------------------------
+
+                     This file is part of Aleph DSP
+
+                https://github.com/bangcorrupt/aleph-dsp
+
+         Aleph DSP is based on monome/aleph and spiricom/LEAF.
+
+                              MIT License
+
+            Aleph dedicated to the public domain by monome.
+
+                LEAF Copyright Jeff Snyder et. al. 2020
+
+                       Copyright bangcorrupt 2024
+
+----------------------------------------------------------------------*/
+/**
+ * @file    aleph_fft.h
+ *
+ * @brief   Public API for fixed point FFT.
+ *
+ *          Complex data is interleaved real and imaginary parts, size
+ *          complex points. Real transforms take 2 * size samples and
+ *          return the spectrum packed as DC, Nyquist, then real and
+ *          imaginary parts for bins 1 to size - 1.
+ *
+ *          Block floating point: each transform returns an exponent, the
+ *          true result is the output scaled by 2^exponent. Inverse
+ *          transforms are unnormalised, a round trip gains size.
+ *
+ *          Tables may be allocated from a separate pool, e.g. a Mempool
+ *          created over L1 data bank B on target.
+ */
+
+#ifndef ALEPH_FFT_H
+#define ALEPH_FFT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*----- Includes -----------------------------------------------------*/
+
+#include "aleph.h"
+
+/*----- Macros -------------------------------------------------------*/
+
+#define ALEPH_FFT_MIN_LOG2_SIZE (2)
+#define ALEPH_FFT_MAX_LOG2_SIZE (12)
+
+/*----- Typedefs -----------------------------------------------------*/
+
+typedef struct {
+    Mempool mempool;
+    Mempool table_mempool;
+    uint16_t size;
+    uint8_t log2_size;
+    fract32 *twiddles;      // cos, sin of 2 pi k / size, k < size / 2.
+    fract32 *real_twiddles; // cos, sin of pi k / size, k <= size / 2.
+    uint16_t *bit_reverse;
+} t_Aleph_FFT;
+
+typedef t_Aleph_FFT *Aleph_FFT;
+
+/*----- Extern variable declarations ---------------------------------*/
+
+/*----- Extern function prototypes -----------------------------------*/
+
+// Size is 2^log2_size complex points.
+void Aleph_FFT_init(Aleph_FFT *const fft, uint8_t log2_size,
+                    t_Aleph *const aleph);
+void Aleph_FFT_init_to_pool(Aleph_FFT *const fft, uint8_t log2_size,
+                            Mempool *const mempool);
+void Aleph_FFT_init_to_pools(Aleph_FFT *const fft, uint8_t log2_size,
+                             Mempool *const mempool,
+                             Mempool *const table_mempool);
+void Aleph_FFT_free(Aleph_FFT *const fft);
+
+// In place, data holds 2 * size values. Returns block exponent.
+int Aleph_FFT_complex_forward(Aleph_FFT *const fft, fract32 *data);
+int Aleph_FFT_complex_inverse(Aleph_FFT *const fft, fract32 *data);
+
+int Aleph_FFT_complex_forward_16(Aleph_FFT *const fft, fract16 *data);
+int Aleph_FFT_complex_inverse_16(Aleph_FFT *const fft, fract16 *data);
+
+// In place, data holds 2 * size real samples. Returns block exponent.
+int Aleph_FFT_real_forward(Aleph_FFT *const fft, fract32 *data);
+int Aleph_FFT_real_inverse(Aleph_FFT *const fft, fract32 *data);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+/*----- End of file --------------------------------------------------*/
@@ -40,6 +40,8 @@
 
 /*----- Static function prototypes -----------------------------------*/
 
+static inline fract32 _hpf_gain_calc(fract32 freq);
+
 /*----- Extern function implementations ------------------------------*/
 
 void Aleph_HPF_init(Aleph_HPF *const hpf, t_Aleph *const aleph) {
@@ -56,9 +58,10 @@ void Aleph_HPF_init_to_pool(Aleph_HPF *const hpf, Mempool *const mempool) {
 
     hp->mempool = mp;
 
-    hp->freq = ALEPH_HPF_DEFAULT_FREQ;
     hp->last_in = 0;
     hp->last_out = 0;
+
+    Aleph_HPF_set_freq(hpf, ALEPH_HPF_DEFAULT_FREQ);
 }
 
 void Aleph_HPF_free(Aleph_HPF *const hpf) {
@@ -68,11 +71,24 @@ void Aleph_HPF_free(Aleph_HPF *const hpf) {
     mpool_free((char *)hp, hp->mempool);
 }
 
+void Aleph_HPF_reset(Aleph_HPF *const hpf) {
+
+    t_Aleph_HPF *hp = *hpf;
+
+    hp->last_in = 0;
+    hp->last_out = 0;
+}
+
 void Aleph_HPF_set_freq(Aleph_HPF *const hpf, fract32 freq) {
 
     t_Aleph_HPF *hp = *hpf;
 
     hp->freq = freq;
+
+    // Coefficients are cached here, the per sample functions do not divide.
+    hp->alpha = freq * 4;
+    hp->gain = _hpf_gain_calc(freq);
+    hp->coeff = _hpf_freq_calc(freq);
 }
 
 fract32 Aleph_HPF_next(Aleph_HPF *const hpf, fract32 in) {
@@ -80,7 +96,7 @@ fract32 Aleph_HPF_next(Aleph_HPF *const hpf, fract32 in) {
     t_Aleph_HPF *hp = *hpf;
 
     // Should be 1 / (2 pi dt fc + 1)
-    fract32 alpha = hp->freq * 4;
+    fract32 alpha = hp->alpha;
 
     hp->last_out =
         add_fr1x32(mult_fr1x32x32(sub_fr1x32(FR32_MAX, alpha), hp->last_out),
@@ -88,7 +104,7 @@ fract32 Aleph_HPF_next(Aleph_HPF *const hpf, fract32 in) {
 
     hp->last_in = in;
 
-    return hp->last_out * (FR32_MAX / hp->freq / 4);
+    return hp->last_out * hp->gain;
 }
 
 fract32 Aleph_HPF_next_precise(Aleph_HPF *const hpf, fract32 in) {
@@ -96,7 +112,7 @@ fract32 Aleph_HPF_next_precise(Aleph_HPF *const hpf, fract32 in) {
     t_Aleph_HPF *hp = *hpf;
 
     // Should be 1 / (2 pi dt fc + 1)
-    fract32 alpha = _hpf_freq_calc(hp->freq);
+    fract32 alpha = hp->coeff;
 
     fract32 out =
         add_fr1x32(mult_fr1x32x32(alpha, hp->last_out),
@@ -156,8 +172,9 @@ void Aleph_LPF_init_to_pool(Aleph_LPF *const lpf, Mempool *const mempool) {
 
     lp->mempool = mp;
 
-    lp->freq = ALEPH_LPF_DEFAULT_FREQ;
     lp->last_out = 0;
+
+    Aleph_LPF_set_freq(lpf, ALEPH_LPF_DEFAULT_FREQ);
 }
 
 void Aleph_LPF_free(Aleph_LPF *const lpf) {
@@ -172,6 +189,9 @@ void Aleph_LPF_set_freq(Aleph_LPF *const lpf, fract32 freq) {
     t_Aleph_LPF *lp = *lpf;
 
     lp->freq = freq;
+
+    lp->alpha = TWOPI * freq;
+    lp->coeff = _lpf_freq_calc(freq);
 }
 
 // the frequency unit is fraction of samplerate
@@ -179,14 +199,14 @@ fract32 Aleph_LPF_next(Aleph_LPF *const lpf, fract32 in) {
 
     t_Aleph_LPF *lp = *lpf;
 
-    return SIMPLE_SLEW(lp->last_out, in, TWOPI * lp->freq);
+    return SIMPLE_SLEW(lp->last_out, in, lp->alpha);
 }
 
 fract32 Aleph_LPF_next_precise(Aleph_LPF *const lpf, fract32 in) {
 
     t_Aleph_LPF *lp = *lpf;
 
-    fract32 alpha = _lpf_freq_calc(lp->freq);
+    fract32 alpha = lp->coeff;
 
     fract32 out =
         add_fr1x32(mult_fr1x32x32(alpha, in),
@@ -294,13 +314,7 @@ fract32 Aleph_HPF_dc_block(Aleph_HPF *const hpf, fract32 in) {
 
     t_Aleph_HPF *hp = *hpf;
 
-    fract32 in_scaled = shr_fr1x32(in, 3);
-    fract32 aux = sub_fr1x32(in_scaled, hp->last_in);
-
-    hp->last_out = add_fr1x32(aux, mult_fr1x32x32(0x7F600000, hp->last_out));
-    hp->last_in = in_scaled;
-
-    return shl_fr1x32(hp->last_out, 3);
+    return _dc_block_calc(hp, in);
 }
 
 fract32 Aleph_HPF_dc_block2(Aleph_HPF *const hpf, fract32 in) {
@@ -318,6 +332,331 @@ fract32 Aleph_HPF_dc_block2(Aleph_HPF *const hpf, fract32 in) {
     return shl_fr1x32(hp->last_out, 3);
 }
 
+void Aleph_HPF_next_block(Aleph_HPF *const hpf, fract32 *input,
+                          fract32 *output, size_t size) {
+
+    t_Aleph_HPF *hp = *hpf;
+
+    fract32 alpha = hp->alpha;
+    fract32 one_minus_alpha = sub_fr1x32(FR32_MAX, alpha);
+    fract32 gain = hp->gain;
+    fract32 last_in = hp->last_in;
+    fract32 last_out = hp->last_out;
+
+    int i;
+    for (i = 0; i < size; i++) {
+
+        last_out =
+            add_fr1x32(mult_fr1x32x32(one_minus_alpha, last_out),
+                       mult_fr1x32x32(alpha, sub_fr1x32(input[i], last_in)));
+
+        last_in = input[i];
+
+        output[i] = last_out * gain;
+    }
+
+    hp->last_in = last_in;
+    hp->last_out = last_out;
+}
+
+void Aleph_HPF_next_block_precise(Aleph_HPF *const hpf, fract32 *input,
+                                  fract32 *output, size_t size) {
+
+    t_Aleph_HPF *hp = *hpf;
+
+    fract32 alpha = hp->coeff;
+    fract32 last_in = hp->last_in;
+    fract32 last_out = hp->last_out;
+
+    int i;
+    for (i = 0; i < size; i++) {
+
+        last_out = add_fr1x32(
+            mult_fr1x32x32(alpha, last_out),
+            mult_fr1x32x32(alpha, sub_fr1x32(input[i], last_in)));
+
+        last_in = input[i];
+
+        output[i] = last_out;
+    }
+
+    hp->last_in = last_in;
+    hp->last_out = last_out;
+}
+
+void Aleph_HPF_next_block_dynamic(Aleph_HPF *const hpf, fract32 freq,
+                                  fract32 *input, fract32 *output,
+                                  size_t size) {
+
+    t_Aleph_HPF *hp = *hpf;
+
+    if (size == 0) {
+        return;
+    }
+
+    fract32 alpha = hp->alpha;
+    fract32 gain = hp->gain;
+    fract32 last_in = hp->last_in;
+    fract32 last_out = hp->last_out;
+
+    Aleph_HPF_set_freq(hpf, freq);
+
+    fract32 alpha_inc = sub_fr1x32(hp->alpha, alpha) / (fract32)size;
+    fract32 gain_inc = sub_fr1x32(hp->gain, gain) / (fract32)size;
+
+    int i;
+    for (i = 0; i < size; i++) {
+
+        alpha += alpha_inc;
+        gain += gain_inc;
+
+        last_out = add_fr1x32(
+            mult_fr1x32x32(sub_fr1x32(FR32_MAX, alpha), last_out),
+            mult_fr1x32x32(alpha, sub_fr1x32(input[i], last_in)));
+
+        last_in = input[i];
+
+        output[i] = last_out * gain;
+    }
+
+    hp->last_in = last_in;
+    hp->last_out = last_out;
+}
+
+void Aleph_HPF_next_block_dynamic_precise(Aleph_HPF *const hpf, fract32 freq,
+                                          fract32 *input, fract32 *output,
+                                          size_t size) {
+
+    t_Aleph_HPF *hp = *hpf;
+
+    if (size == 0) {
+        return;
+    }
+
+    fract32 alpha = hp->coeff;
+    fract32 last_in = hp->last_in;
+    fract32 last_out = hp->last_out;
+
+    Aleph_HPF_set_freq(hpf, freq);
+
+    fract32 alpha_inc = sub_fr1x32(hp->coeff, alpha) / (fract32)size;
+
+    int i;
+    for (i = 0; i < size; i++) {
+
+        alpha += alpha_inc;
+
+        last_out = add_fr1x32(
+            mult_fr1x32x32(alpha, last_out),
+            mult_fr1x32x32(alpha, sub_fr1x32(input[i], last_in)));
+
+        last_in = input[i];
+
+        output[i] = last_out;
+    }
+
+    hp->last_in = last_in;
+    hp->last_out = last_out;
+}
+
+void Aleph_LPF_next_block(Aleph_LPF *const lpf, fract32 *input,
+                          fract32 *output, size_t size) {
+
+    t_Aleph_LPF *lp = *lpf;
+
+    fract32 alpha = lp->alpha;
+    fract32 last_out = lp->last_out;
+
+    int i;
+    for (i = 0; i < size; i++) {
+
+        output[i] = SIMPLE_SLEW(last_out, input[i], alpha);
+    }
+
+    lp->last_out = last_out;
+}
+
+void Aleph_LPF_next_block_precise(Aleph_LPF *const lpf, fract32 *input,
+                                  fract32 *output, size_t size) {
+
+    t_Aleph_LPF *lp = *lpf;
+
+    fract32 alpha = lp->coeff;
+    fract32 one_minus_alpha = sub_fr1x32(FR32_MAX, alpha);
+    fract32 last_out = lp->last_out;
+
+    int i;
+    for (i = 0; i < size; i++) {
+
+        last_out = add_fr1x32(mult_fr1x32x32(alpha, input[i]),
+                              mult_fr1x32x32(one_minus_alpha, last_out));
+
+        output[i] = last_out;
+    }
+
+    lp->last_out = last_out;
+}
+
+void Aleph_LPF_next_block_dynamic(Aleph_LPF *const lpf, fract32 freq,
+                                  fract32 *input, fract32 *output,
+                                  size_t size) {
+
+    t_Aleph_LPF *lp = *lpf;
+
+    if (size == 0) {
+        return;
+    }
+
+    fract32 alpha = lp->alpha;
+    fract32 last_out = lp->last_out;
+
+    Aleph_LPF_set_freq(lpf, freq);
+
+    fract32 alpha_inc = sub_fr1x32(lp->alpha, alpha) / (fract32)size;
+
+    int i;
+    for (i = 0; i < size; i++) {
+
+        alpha += alpha_inc;
+
+        output[i] = SIMPLE_SLEW(last_out, input[i], alpha);
+    }
+
+    lp->last_out = last_out;
+}
+
+void Aleph_LPF_next_block_dynamic_precise(Aleph_LPF *const lpf, fract32 freq,
+                                          fract32 *input, fract32 *output,
+                                          size_t size) {
+
+    t_Aleph_LPF *lp = *lpf;
+
+    if (size == 0) {
+        return;
+    }
+
+    fract32 alpha = lp->coeff;
+    fract32 last_out = lp->last_out;
+
+    Aleph_LPF_set_freq(lpf, freq);
+
+    fract32 alpha_inc = sub_fr1x32(lp->coeff, alpha) / (fract32)size;
+
+    int i;
+    for (i = 0; i < size; i++) {
+
+        alpha += alpha_inc;
+
+        last_out = add_fr1x32(
+            mult_fr1x32x32(alpha, input[i]),
+            mult_fr1x32x32(sub_fr1x32(FR32_MAX, alpha), last_out));
+
+        output[i] = last_out;
+    }
+
+    lp->last_out = last_out;
+}
+
+// Filters run back to back over the block, the second one in place.
+void Aleph_BPF_next_block(Aleph_BPF *const bpf, fract32 *input,
+                          fract32 *output, size_t size) {
+
+    t_Aleph_BPF *bp = *bpf;
+
+    Aleph_HPF_next_block(&bp->hp, input, output, size);
+    Aleph_LPF_next_block(&bp->lp, output, output, size);
+}
+
+void Aleph_BPF_next_block_precise(Aleph_BPF *const bpf, fract32 *input,
+                                  fract32 *output, size_t size) {
+
+    t_Aleph_BPF *bp = *bpf;
+
+    Aleph_HPF_next_block_precise(&bp->hp, input, output, size);
+    Aleph_LPF_next_block_precise(&bp->lp, output, output, size);
+}
+
+void Aleph_BPF_next_block_dynamic(Aleph_BPF *const bpf, fract32 hp_freq,
+                                  fract32 lp_freq, fract32 *input,
+                                  fract32 *output, size_t size) {
+
+    t_Aleph_BPF *bp = *bpf;
+
+    Aleph_HPF_next_block_dynamic(&bp->hp, hp_freq, input, output, size);
+    Aleph_LPF_next_block_dynamic(&bp->lp, lp_freq, output, output, size);
+}
+
+void Aleph_BPF_next_block_dynamic_precise(Aleph_BPF *const bpf,
+                                          fract32 hp_freq, fract32 lp_freq,
+                                          fract32 *input, fract32 *output,
+                                          size_t size) {
+
+    t_Aleph_BPF *bp = *bpf;
+
+    Aleph_HPF_next_block_dynamic_precise(&bp->hp, hp_freq, input, output,
+                                         size);
+    Aleph_LPF_next_block_dynamic_precise(&bp->lp, lp_freq, output, output,
+                                         size);
+}
+
+void Aleph_HPF_dc_block_next_block(Aleph_HPF *const hpf, fract32 *input,
+                                   fract32 *output, size_t size) {
+
+    t_Aleph_HPF *hp = *hpf;
+
+    fract32 last_in = hp->last_in;
+    fract32 last_out = hp->last_out;
+    fract32 in_scaled;
+
+    int i;
+    for (i = 0; i < size; i++) {
+
+        in_scaled = shr_fr1x32(input[i], 3);
+
+        last_out = add_fr1x32(sub_fr1x32(in_scaled, last_in),
+                              mult_fr1x32x32(0x7F600000, last_out));
+        last_in = in_scaled;
+
+        output[i] = shl_fr1x32(last_out, 3);
+    }
+
+    hp->last_in = last_in;
+    hp->last_out = last_out;
+}
+
+void Aleph_HPF_dc_block2_next_block(Aleph_HPF *const hpf, fract32 *input,
+                                    fract32 *output, size_t size) {
+
+    t_Aleph_HPF *hp = *hpf;
+
+    fract32 last_in = hp->last_in;
+    fract32 last_out = hp->last_out;
+    fract32 in_scaled;
+
+    int i;
+    for (i = 0; i < size; i++) {
+
+        in_scaled = shr_fr1x32(input[i], 3);
+
+        last_out = mult_fr1x32x32(
+            sub_fr1x32(add_fr1x32(in_scaled, last_out), last_in), 0x7F600000);
+        last_in = in_scaled;
+
+        output[i] = shl_fr1x32(last_out, 3);
+    }
+
+    hp->last_in = last_in;
+    hp->last_out = last_out;
+}
+
 /*----- Static function implementations ------------------------------*/
 
+static inline fract32 _hpf_gain_calc(fract32 freq) {
+    if (freq > 0) {
+        return FR32_MAX / freq / 4;
+    } else {
+        return 0;
+    }
+}
+
 /*----- End of file --------------------------------------------------*/
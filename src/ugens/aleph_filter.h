@@ -48,6 +48,9 @@ typedef struct {
     fract32 last_in;
     fract32 last_out;
     fract32 freq;
+    fract32 alpha; // freq * 4
+    fract32 gain;  // FR32_MAX / freq / 4
+    fract32 coeff; // _hpf_freq_calc(freq)
 } t_Aleph_HPF;
 
 typedef t_Aleph_HPF *Aleph_HPF;
@@ -56,6 +59,8 @@ typedef struct {
     Mempool mempool;
     fract32 last_out;
     fract32 freq;
+    fract32 alpha; // TWOPI * freq
+    fract32 coeff; // _lpf_freq_calc(freq)
 } t_Aleph_LPF;
 
 typedef t_Aleph_LPF *Aleph_LPF;
@@ -76,6 +81,8 @@ void Aleph_HPF_init(Aleph_HPF *const hpf, t_Aleph *const aleph);
 void Aleph_HPF_init_to_pool(Aleph_HPF *const hpf, Mempool *const mempool);
 void Aleph_HPF_free(Aleph_HPF *const hpf);
 
+void Aleph_HPF_reset(Aleph_HPF *const hpf);
+
 void Aleph_HPF_set_freq(Aleph_HPF *const hpf, fract32 freq);
 
 fract32 Aleph_HPF_next(Aleph_HPF *const hpf, fract32 in);
@@ -84,6 +91,19 @@ fract32 Aleph_HPF_next_dynamic(Aleph_HPF *const hpf, fract32 in, fract32 freq);
 fract32 Aleph_HPF_next_dynamic_precise(Aleph_HPF *const hpf, fract32 in,
                                        fract32 freq);
 
+void Aleph_HPF_next_block(Aleph_HPF *const hpf, fract32 *input,
+                          fract32 *output, size_t size);
+void Aleph_HPF_next_block_precise(Aleph_HPF *const hpf, fract32 *input,
+                                  fract32 *output, size_t size);
+
+// Ramp coefficients from the current frequency to `freq` over the block.
+void Aleph_HPF_next_block_dynamic(Aleph_HPF *const hpf, fract32 freq,
+                                  fract32 *input, fract32 *output,
+                                  size_t size);
+void Aleph_HPF_next_block_dynamic_precise(Aleph_HPF *const hpf, fract32 freq,
+                                          fract32 *input, fract32 *output,
+                                          size_t size);
+
 void Aleph_LPF_init(Aleph_LPF *const lpf, t_Aleph *const aleph);
 void Aleph_LPF_init_to_pool(Aleph_LPF *const lpf, Mempool *const mempool);
 void Aleph_LPF_free(Aleph_LPF *const lpf);
@@ -96,6 +116,19 @@ fract32 Aleph_LPF_next_dynamic(Aleph_LPF *const lpf, fract32 in, fract32 freq);
 fract32 Aleph_LPF_next_dynamic_precise(Aleph_LPF *const lpf, fract32 in,
                                        fract32 freq);
 
+void Aleph_LPF_next_block(Aleph_LPF *const lpf, fract32 *input,
+                          fract32 *output, size_t size);
+void Aleph_LPF_next_block_precise(Aleph_LPF *const lpf, fract32 *input,
+                                  fract32 *output, size_t size);
+
+// Ramp coefficients from the current frequency to `freq` over the block.
+void Aleph_LPF_next_block_dynamic(Aleph_LPF *const lpf, fract32 freq,
+                                  fract32 *input, fract32 *output,
+                                  size_t size);
+void Aleph_LPF_next_block_dynamic_precise(Aleph_LPF *const lpf, fract32 freq,
+                                          fract32 *input, fract32 *output,
+                                          size_t size);
+
 void Aleph_BPF_init(Aleph_BPF *const bpf, t_Aleph *const aleph);
 void Aleph_BPF_init_to_pool(Aleph_BPF *const bpf, Mempool *const mempool);
 void Aleph_BPF_free(Aleph_BPF *const bpf);
@@ -111,9 +144,27 @@ fract32 Aleph_BPF_next_dynamic(Aleph_BPF *const bpf, fract32 in,
 fract32 Aleph_BPF_next_dynamic_precise(Aleph_BPF *const bpf, fract32 in,
                                        fract32 hp_freq, fract32 lp_freq);
 
+void Aleph_BPF_next_block(Aleph_BPF *const bpf, fract32 *input,
+                          fract32 *output, size_t size);
+void Aleph_BPF_next_block_precise(Aleph_BPF *const bpf, fract32 *input,
+                                  fract32 *output, size_t size);
+
+void Aleph_BPF_next_block_dynamic(Aleph_BPF *const bpf, fract32 hp_freq,
+                                  fract32 lp_freq, fract32 *input,
+                                  fract32 *output, size_t size);
+void Aleph_BPF_next_block_dynamic_precise(Aleph_BPF *const bpf,
+                                          fract32 hp_freq, fract32 lp_freq,
+                                          fract32 *input, fract32 *output,
+                                          size_t size);
+
 fract32 Aleph_HPF_dc_block(Aleph_HPF *const hpf, fract32 in);
 fract32 Aleph_HPF_dc_block2(Aleph_HPF *const hpf, fract32 in);
 
+void Aleph_HPF_dc_block_next_block(Aleph_HPF *const hpf, fract32 *input,
+                                   fract32 *output, size_t size);
+void Aleph_HPF_dc_block2_next_block(Aleph_HPF *const hpf, fract32 *input,
+                                    fract32 *output, size_t size);
+
 /*----- Static function implementations ------------------------------*/
 
 /// TODO: Move these to filter.c if they are not used elsewhere.
@@ -130,6 +181,17 @@ static inline fract32 _lpf_freq_calc(fract32 freq) {
     return ((temp << 12) / ((1 << 16) + temp)) << 19;
 }
 
+// One sample of Aleph_HPF_dc_block, for fusing into other block kernels.
+static inline fract32 _dc_block_calc(t_Aleph_HPF *hp, fract32 in) {
+    fract32 in_scaled = shr_fr1x32(in, 3);
+
+    hp->last_out = add_fr1x32(sub_fr1x32(in_scaled, hp->last_in),
+                              mult_fr1x32x32(0x7F600000, hp->last_out));
+    hp->last_in = in_scaled;
+
+    return shl_fr1x32(hp->last_out, 3);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -50,6 +50,11 @@ static void _calc_frame(Aleph_FilterSVF *const filter, fract32 in);
 static void _softclip_calc_frame(Aleph_FilterSVF *const filter, fract32 in);
 static void _softclip_asym_calc_frame(Aleph_FilterSVF *const filter,
                                       fract32 in);
+static void _sc_next_block(t_Aleph_FilterSVF *fl, fract32 *state,
+                           fract32 *input, fract32 *output, size_t size);
+static void _sc_os_next_block_ramp(t_Aleph_FilterSVF *fl, fract32 *state,
+                                   t_Aleph_Ramp *freq, fract32 *input,
+                                   fract32 *output, size_t size);
 
 /*----- Extern function implementations ------------------------------*/
 
@@ -72,6 +77,8 @@ void Aleph_FilterSVF_init_to_pool(Aleph_FilterSVF *const filter,
     fl->low = fl->high = fl->band = fl->notch = 0;
     fl->low_mix = fl->high_mix = fl->band_mix = fl->notch_mix = fl->peak_mix =
         0;
+
+    fl->dc_block = NULL;
 }
 
 void Aleph_FilterSVF_free(Aleph_FilterSVF *const filter) {
@@ -81,6 +88,13 @@ void Aleph_FilterSVF_free(Aleph_FilterSVF *const filter) {
     mpool_free((char *)fl, fl->mempool);
 }
 
+void Aleph_FilterSVF_reset(Aleph_FilterSVF *const filter) {
+
+    t_Aleph_FilterSVF *fl = *filter;
+
+    fl->low = fl->high = fl->band = fl->notch = 0;
+}
+
 // Set reciprocal of Q.
 void Aleph_FilterSVF_set_rq(Aleph_FilterSVF *const filter, fract32 rq) {
 
@@ -102,6 +116,18 @@ void Aleph_FilterSVF_set_coeff(Aleph_FilterSVF *const filter, fract32 coeff) {
     fl->freq = coeff;
 }
 
+void Aleph_FilterSVF_set_dc_block(Aleph_FilterSVF *const filter,
+                                  Aleph_HPF *const dc_block) {
+
+    t_Aleph_FilterSVF *fl = *filter;
+
+    if (dc_block != NULL) {
+        fl->dc_block = *dc_block;
+    } else {
+        fl->dc_block = NULL;
+    }
+}
+
 // Set output mixes.
 void Aleph_FilterSVF_set_low(Aleph_FilterSVF *const filter, fract32 mix) {
 
@@ -231,6 +257,8 @@ void Aleph_FilterSVF_sc_os_lpf_next_block(Aleph_FilterSVF *const filter,
 
     t_Aleph_FilterSVF *fl = *filter;
 
+    t_Aleph_HPF *dc_block = fl->dc_block;
+
     fract32 in;
     fract32 out;
 
@@ -246,6 +274,10 @@ void Aleph_FilterSVF_sc_os_lpf_next_block(Aleph_FilterSVF *const filter,
         _softclip_calc_frame(&fl, in);
         out = add_fr1x32(out, shr_fr1x32(fl->low, 1));
 
+        if (dc_block != NULL) {
+            out = _dc_block_calc(dc_block, out);
+        }
+
         output[i] = out;
     }
 }
@@ -256,6 +288,8 @@ void Aleph_FilterSVF_sc_os_lpf_next_block_smooth(Aleph_FilterSVF *const filter,
 
     t_Aleph_FilterSVF *fl = *filter;
 
+    t_Aleph_HPF *dc_block = fl->dc_block;
+
     fract32 in;
     fract32 out;
 
@@ -273,10 +307,71 @@ void Aleph_FilterSVF_sc_os_lpf_next_block_smooth(Aleph_FilterSVF *const filter,
         _softclip_calc_frame(&fl, in);
         out = add_fr1x32(out, shr_fr1x32(fl->low, 1));
 
+        if (dc_block != NULL) {
+            out = _dc_block_calc(dc_block, out);
+        }
+
         output[i] = out;
     }
 }
 
+void Aleph_FilterSVF_sc_os_lpf_next_block_ramp(Aleph_FilterSVF *const filter,
+                                               t_Aleph_Ramp *freq,
+                                               fract32 *input, fract32 *output,
+                                               size_t size) {
+
+    t_Aleph_FilterSVF *fl = *filter;
+
+    _sc_os_next_block_ramp(fl, &fl->low, freq, input, output, size);
+}
+
+void Aleph_FilterSVF_sc_os_bpf_next_block_ramp(Aleph_FilterSVF *const filter,
+                                               t_Aleph_Ramp *freq,
+                                               fract32 *input, fract32 *output,
+                                               size_t size) {
+
+    t_Aleph_FilterSVF *fl = *filter;
+
+    _sc_os_next_block_ramp(fl, &fl->band, freq, input, output, size);
+}
+
+void Aleph_FilterSVF_sc_os_hpf_next_block_ramp(Aleph_FilterSVF *const filter,
+                                               t_Aleph_Ramp *freq,
+                                               fract32 *input, fract32 *output,
+                                               size_t size) {
+
+    t_Aleph_FilterSVF *fl = *filter;
+
+    _sc_os_next_block_ramp(fl, &fl->high, freq, input, output, size);
+}
+
+void Aleph_FilterSVF_sc_lpf_next_block(Aleph_FilterSVF *const filter,
+                                       fract32 *input, fract32 *output,
+                                       size_t size) {
+
+    t_Aleph_FilterSVF *fl = *filter;
+
+    _sc_next_block(fl, &fl->low, input, output, size);
+}
+
+void Aleph_FilterSVF_sc_bpf_next_block(Aleph_FilterSVF *const filter,
+                                       fract32 *input, fract32 *output,
+                                       size_t size) {
+
+    t_Aleph_FilterSVF *fl = *filter;
+
+    _sc_next_block(fl, &fl->band, input, output, size);
+}
+
+void Aleph_FilterSVF_sc_hpf_next_block(Aleph_FilterSVF *const filter,
+                                       fract32 *input, fract32 *output,
+                                       size_t size) {
+
+    t_Aleph_FilterSVF *fl = *filter;
+
+    _sc_next_block(fl, &fl->high, input, output, size);
+}
+
 fract32 Aleph_FilterSVF_sc_asym_lpf_next(Aleph_FilterSVF *const filter,
                                          fract32 in) {
 
@@ -515,4 +610,61 @@ static void _softclip_asym_calc_frame(Aleph_FilterSVF *const filter,
         clip_radix);
 }
 
+// Soft clipped block at fixed coefficients, `state` selects the response.
+static void _sc_next_block(t_Aleph_FilterSVF *fl, fract32 *state,
+                           fract32 *input, fract32 *output, size_t size) {
+
+    t_Aleph_HPF *dc_block = fl->dc_block;
+
+    fract32 out;
+
+    int i;
+    for (i = 0; i < size; i++) {
+
+        // Allows using same buffer for input and output.
+        _softclip_calc_frame(&fl, input[i]);
+        out = *state;
+
+        if (dc_block != NULL) {
+            out = _dc_block_calc(dc_block, out);
+        }
+
+        output[i] = out;
+    }
+}
+
+// Soft clipped, oversampled block with the cutoff ramped per sample.
+static void _sc_os_next_block_ramp(t_Aleph_FilterSVF *fl, fract32 *state,
+                                   t_Aleph_Ramp *freq, fract32 *input,
+                                   fract32 *output, size_t size) {
+
+    t_Aleph_HPF *dc_block = fl->dc_block;
+
+    fract32 in;
+    fract32 out;
+
+    fl->freq = freq->start;
+
+    int i;
+    for (i = 0; i < size; i++) {
+
+        // Allows using same buffer for input and output.
+        in = input[i];
+
+        fl->freq = add_fr1x32(fl->freq, freq->inc);
+
+        _softclip_calc_frame(&fl, in);
+        out = shr_fr1x32(*state, 1);
+
+        _softclip_calc_frame(&fl, in);
+        out = add_fr1x32(out, shr_fr1x32(*state, 1));
+
+        if (dc_block != NULL) {
+            out = _dc_block_calc(dc_block, out);
+        }
+
+        output[i] = out;
+    }
+}
+
 /*----- End of file --------------------------------------------------*/
@@ -35,6 +35,9 @@ extern "C" {
 
 #include "aleph.h"
 
+#include "aleph_filter.h"
+#include "aleph_interpolate.h"
+
 /*----- Macros -------------------------------------------------------*/
 
 /*----- Typedefs -----------------------------------------------------*/
@@ -68,6 +71,9 @@ typedef struct {
     // Kinda weird, but use rshift for rq values >=1
     uint8_t rq_shift;
 
+    // Optional DC blocker applied by block kernels, NULL to disable.
+    t_Aleph_HPF *dc_block;
+
 } t_Aleph_FilterSVF;
 
 typedef t_Aleph_FilterSVF *Aleph_FilterSVF;
@@ -86,6 +92,8 @@ void Aleph_FilterSVF_init(Aleph_FilterSVF *const filter, t_Aleph *const aleph);
 void Aleph_FilterSVF_init_to_pool(Aleph_FilterSVF *const filter,
                                   Mempool *const mempool);
 void Aleph_FilterSVF_free(Aleph_FilterSVF *const filter);
+// clear filter state
+void Aleph_FilterSVF_reset(Aleph_FilterSVF *const filter);
 // set cutoff in hz
 //  void t_Aleph_FilterSVF_set_hz    ( t_Aleph_FilterSVF* f, fix16 hz );
 // set cutoff coefficient
@@ -93,6 +101,10 @@ void Aleph_FilterSVF_set_coeff(Aleph_FilterSVF *const filter, fract32 coeff);
 
 // set RQ (reciprocal of q: resonance/bandwidth)
 void Aleph_FilterSVF_set_rq(Aleph_FilterSVF *const filter, fract32 rq);
+// Block kernels apply `dc_block` to their output, NULL disables.
+void Aleph_FilterSVF_set_dc_block(Aleph_FilterSVF *const filter,
+                                  Aleph_HPF *const dc_block);
+
 // set output mixes
 void Aleph_FilterSVF_set_low(Aleph_FilterSVF *const filter, fract32 mix);
 void Aleph_FilterSVF_set_high(Aleph_FilterSVF *const filter, fract32 mix);
@@ -136,6 +148,17 @@ fract32 Aleph_FilterSVF_sc_asym_hpf_next(Aleph_FilterSVF *const filter,
 fract32 Aleph_FilterSVF_sc_asym_notch_next(Aleph_FilterSVF *const filter,
                                            fract32 in);
 
+// Fixed coefficient blocks, apply `dc_block` set on the filter.
+void Aleph_FilterSVF_sc_lpf_next_block(Aleph_FilterSVF *const filter,
+                                       fract32 *input, fract32 *output,
+                                       size_t size);
+void Aleph_FilterSVF_sc_bpf_next_block(Aleph_FilterSVF *const filter,
+                                       fract32 *input, fract32 *output,
+                                       size_t size);
+void Aleph_FilterSVF_sc_hpf_next_block(Aleph_FilterSVF *const filter,
+                                       fract32 *input, fract32 *output,
+                                       size_t size);
+
 void Aleph_FilterSVF_sc_os_lpf_next_block(Aleph_FilterSVF *const filter,
                                           fract32 *input, fract32 *output,
                                           size_t size);
@@ -143,6 +166,21 @@ void Aleph_FilterSVF_sc_os_lpf_next_block(Aleph_FilterSVF *const filter,
 void Aleph_FilterSVF_sc_os_lpf_next_block_smooth(Aleph_FilterSVF *const filter,
                                                  fract32 *freq, fract32 *input,
                                                  fract32 *output, size_t size);
+
+// Cutoff ramped across the block, apply `dc_block` set on the filter.
+void Aleph_FilterSVF_sc_os_lpf_next_block_ramp(Aleph_FilterSVF *const filter,
+                                               t_Aleph_Ramp *freq,
+                                               fract32 *input, fract32 *output,
+                                               size_t size);
+void Aleph_FilterSVF_sc_os_bpf_next_block_ramp(Aleph_FilterSVF *const filter,
+                                               t_Aleph_Ramp *freq,
+                                               fract32 *input, fract32 *output,
+                                               size_t size);
+void Aleph_FilterSVF_sc_os_hpf_next_block_ramp(Aleph_FilterSVF *const filter,
+                                               t_Aleph_Ramp *freq,
+                                               fract32 *input, fract32 *output,
+                                               size_t size);
+
 #ifdef __cplusplus
 }
 #endif
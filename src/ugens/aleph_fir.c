@@ -0,0 +1,265 @@
+/*----------------------------------------------------------------------
+
+                     This file is part of Aleph DSP
+
+                https://github.com/bangcorrupt/aleph-dsp
+
+         Aleph DSP is based on monome/aleph and spiricom/LEAF.
+
+                              MIT License
+
+            Aleph dedicated to the public domain by monome.
+
+                LEAF Copyright Jeff Snyder et. al. 2020
+
+                       Copyright bangcorrupt 2024
+
+----------------------------------------------------------------------*/
+/**
+ * @file    aleph_fir.c
+ *
+ * @brief   Block FIR filter.
+ *
+ *          On Blackfin the delay line is exactly num_taps long and the
+ *          inner loop walks it with a compare and wrap pointer, which
+ *          avoids the mask and suits circular addressing. Whether the
+ *          compiler uses the I/L/B registers has not been checked. The
+ *          int64_t accumulator is portable C and does not map onto the
+ *          40-bit A0/A1 MAC. Elsewhere the delay line is a power of two
+ *          and indices are masked.
+ */
+
+/*----- Includes -----------------------------------------------------*/
+
+#include "aleph.h"
+
+#include "aleph_utils.h"
+
+#include "aleph_fir.h"
+
+/*----- Macros -------------------------------------------------------*/
+
+/*----- Typedefs -----------------------------------------------------*/
+
+/*----- Static variable definitions ----------------------------------*/
+
+/*----- Extern variable definitions ----------------------------------*/
+
+/*----- Static function prototypes -----------------------------------*/
+
+
+/*----- Extern function implementations ------------------------------*/
+
+void Aleph_FIR_init(Aleph_FIR *const fir, uint16_t num_taps,
+                    uint8_t num_channels, t_Aleph *const aleph) {
+
+    Aleph_FIR_init_to_pool(fir, num_taps, num_channels, &aleph->mempool);
+}
+
+void Aleph_FIR_init_to_pool(Aleph_FIR *const fir, uint16_t num_taps,
+                            uint8_t num_channels, Mempool *const mempool) {
+
+    t_Mempool *mp = *mempool;
+
+    t_Aleph_FIR *fr = *fir =
+        (t_Aleph_FIR *)mpool_alloc(sizeof(t_Aleph_FIR), mp);
+
+    fr->mempool = mp;
+
+    if (num_taps < 1) {
+        num_taps = 1;
+    } else if (num_taps > ALEPH_FIR_MAX_TAPS) {
+        num_taps = ALEPH_FIR_MAX_TAPS;
+    }
+
+    if (num_channels < 1) {
+        num_channels = 1;
+    } else if (num_channels > ALEPH_FIR_MAX_CHANNELS) {
+        num_channels = ALEPH_FIR_MAX_CHANNELS;
+    }
+
+    fr->num_taps = num_taps;
+    fr->num_channels = num_channels;
+    fr->index = 0;
+
+#ifdef __bfin__
+    fr->buffer_size = num_taps;
+#else
+    fr->buffer_size = 1;
+    while (fr->buffer_size < num_taps) {
+        fr->buffer_size <<= 1;
+    }
+#endif
+
+    fr->coeffs = (fract32 *)mpool_calloc(sizeof(fract32) * num_taps, mp);
+
+    fr->state = (fract32 *)mpool_calloc(
+        sizeof(fract32) * fr->buffer_size * num_channels, mp);
+}
+
+void Aleph_FIR_free(Aleph_FIR *const fir) {
+
+    t_Aleph_FIR *fr = *fir;
+
+    mpool_free((char *)fr->state, fr->mempool);
+    mpool_free((char *)fr->coeffs, fr->mempool);
+    mpool_free((char *)fr, fr->mempool);
+}
+
+void Aleph_FIR_reset(Aleph_FIR *const fir) {
+
+    t_Aleph_FIR *fr = *fir;
+
+    int i;
+    for (i = 0; i < fr->buffer_size * fr->num_channels; i++) {
+        fr->state[i] = 0;
+    }
+
+    fr->index = 0;
+}
+
+void Aleph_FIR_set_coeffs(Aleph_FIR *const fir, fract32 *coeffs) {
+
+    t_Aleph_FIR *fr = *fir;
+
+    int i;
+    for (i = 0; i < fr->num_taps; i++) {
+        fr->coeffs[i] = coeffs[fr->num_taps - 1 - i];
+    }
+}
+
+void Aleph_FIR_next_block(Aleph_FIR *const fir, fract32 *input,
+                          fract32 *output, size_t size) {
+
+    t_Aleph_FIR *fr = *fir;
+
+    fract32 *h = fr->coeffs;
+    fract32 *buf = fr->state;
+    uint16_t taps = fr->num_taps;
+    uint16_t index = fr->index;
+    int64_t acc;
+
+#ifdef __bfin__
+    fract32 *end = buf + taps;
+    fract32 *p;
+#else
+    uint16_t mask = fr->buffer_size - 1;
+    uint16_t start;
+#endif
+
+    int i, j;
+    for (i = 0; i < size; i++) {
+
+        buf[index] = input[i];
+
+        acc = 0;
+
+#ifdef __bfin__
+        // Oldest sample follows the newest.
+        p = buf + index + 1;
+        if (p == end) {
+            p = buf;
+        }
+
+        for (j = 0; j < taps; j++) {
+            acc += (int64_t)h[j] * *p;
+            if (++p == end) {
+                p = buf;
+            }
+        }
+
+        if (++index == taps) {
+            index = 0;
+        }
+#else
+        start = index - taps + 1;
+
+        for (j = 0; j < taps; j++) {
+            acc += (int64_t)h[j] * buf[(start + j) & mask];
+        }
+
+        index = (index + 1) & mask;
+#endif
+
+        output[i] = sat_fr32(acc >> 31);
+    }
+
+    fr->index = index;
+}
+
+void Aleph_FIR_next_block_multi(Aleph_FIR *const fir, fract32 **input,
+                                fract32 **output, size_t size) {
+
+    t_Aleph_FIR *fr = *fir;
+
+    fract32 *h = fr->coeffs;
+    fract32 *buf = fr->state;
+    uint16_t taps = fr->num_taps;
+    uint16_t stride = fr->buffer_size;
+    uint8_t channels = fr->num_channels;
+    uint16_t index = fr->index;
+    int64_t acc[ALEPH_FIR_MAX_CHANNELS];
+    fract32 coeff;
+
+#ifdef __bfin__
+    fract32 *end = buf + taps;
+    fract32 *p;
+#else
+    uint16_t mask = fr->buffer_size - 1;
+    uint16_t start;
+    uint16_t k;
+#endif
+
+    int i, j, c;
+    for (i = 0; i < size; i++) {
+
+        for (c = 0; c < channels; c++) {
+            buf[c * stride + index] = input[c][i];
+            acc[c] = 0;
+        }
+
+#ifdef __bfin__
+        // Channel delay lines are a fixed stride from the first.
+        p = buf + index + 1;
+        if (p == end) {
+            p = buf;
+        }
+
+        for (j = 0; j < taps; j++) {
+            coeff = h[j];
+            for (c = 0; c < channels; c++) {
+                acc[c] += (int64_t)coeff * p[c * stride];
+            }
+            if (++p == end) {
+                p = buf;
+            }
+        }
+
+        if (++index == taps) {
+            index = 0;
+        }
+#else
+        start = index - taps + 1;
+
+        for (j = 0; j < taps; j++) {
+            coeff = h[j];
+            k = (start + j) & mask;
+            for (c = 0; c < channels; c++) {
+                acc[c] += (int64_t)coeff * buf[c * stride + k];
+            }
+        }
+
+        index = (index + 1) & mask;
+#endif
+
+        for (c = 0; c < channels; c++) {
+            output[c][i] = sat_fr32(acc[c] >> 31);
+        }
+    }
+
+    fr->index = index;
+}
+
+/*----- Static function implementations ------------------------------*/
+
+/*----- End of file --------------------------------------------------*/
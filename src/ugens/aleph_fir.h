@@ -0,0 +1,90 @@
+/*----------------------------------------------------------------------
+
+                     This file is part of Aleph DSP
+
+                https://github.com/bangcorrupt/aleph-dsp
+
+         Aleph DSP is based on monome/aleph and spiricom/LEAF.
+
+                              MIT License
+
+            Aleph dedicated to the public domain by monome.
+
+                LEAF Copyright Jeff Snyder et. al. 2020
+
+                       Copyright bangcorrupt 2024
+
+----------------------------------------------------------------------*/
+/**
+ * @file    aleph_fir.h
+ *
+ * @brief   Public API for block FIR filter.
+ *
+ *          One set of coefficients is shared by up to
+ *          ALEPH_FIR_MAX_CHANNELS channels, each with its own delay line.
+ */
+
+#ifndef ALEPH_FIR_H
+#define ALEPH_FIR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*----- Includes -----------------------------------------------------*/
+
+#include "aleph.h"
+
+/*----- Macros -------------------------------------------------------*/
+
+#define ALEPH_FIR_MAX_CHANNELS (4)
+
+// Largest power of two buffer that fits buffer_size, longer filters clamp.
+#define ALEPH_FIR_MAX_TAPS (32768)
+
+/*----- Typedefs -----------------------------------------------------*/
+
+typedef struct {
+    Mempool mempool;
+    uint16_t num_taps;
+    uint8_t num_channels;
+    uint16_t buffer_size;
+    uint16_t index;
+    fract32 *coeffs; // Reversed, oldest sample first.
+    fract32 *state;  // buffer_size per channel.
+} t_Aleph_FIR;
+
+typedef t_Aleph_FIR *Aleph_FIR;
+
+/*----- Extern variable declarations ---------------------------------*/
+
+/*----- Extern function prototypes -----------------------------------*/
+
+void Aleph_FIR_init(Aleph_FIR *const fir, uint16_t num_taps,
+                    uint8_t num_channels, t_Aleph *const aleph);
+void Aleph_FIR_init_to_pool(Aleph_FIR *const fir, uint16_t num_taps,
+                            uint8_t num_channels, Mempool *const mempool);
+void Aleph_FIR_free(Aleph_FIR *const fir);
+
+void Aleph_FIR_reset(Aleph_FIR *const fir);
+
+// Copies num_taps coefficients, first coefficient applies to the newest
+// sample.
+void Aleph_FIR_set_coeffs(Aleph_FIR *const fir, fract32 *coeffs);
+
+// Single channel filters.
+// Allows using same buffer for input and output.
+void Aleph_FIR_next_block(Aleph_FIR *const fir, fract32 *input,
+                          fract32 *output, size_t size);
+
+// One buffer per channel, each tap is loaded once for all channels.
+// Allows using same buffers for input and output.
+void Aleph_FIR_next_block_multi(Aleph_FIR *const fir, fract32 **input,
+                                fract32 **output, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+/*----- End of file --------------------------------------------------*/
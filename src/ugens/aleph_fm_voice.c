@@ -38,14 +38,172 @@
 
 /*----- Macros -------------------------------------------------------*/
 
+// Algorithm kernels are generated from the macros below. Operator count
+// and routing are fixed, so operator state stays in local variables and
+// only the gains are read from the voice.
+
+// Modulation input from zero, one or two source operators, ascending.
+#define ALEPH_FM_ALG_MOD_0(i) (0)
+#define ALEPH_FM_ALG_MOD_1(i, a) multr_fr1x16(out[a], gain[i][0])
+#define ALEPH_FM_ALG_MOD_2(i, a, b)                                            \
+    add_fr1x16(multr_fr1x16(out[a], gain[i][0]),                               \
+               multr_fr1x16(out[b], gain[i][1]))
+
+// Operator frame with band limited, saturated modulation.
+#define ALEPH_FM_ALG_OP(i, mod)                                                \
+    do {                                                                       \
+        fract16 op_mod = shr_fr1x32((mod), 2);                                 \
+                                                                               \
+        op_mod = mult_fr1x16(op_mod, FR16_MAX - ALEPH_FM_SMOOTH);              \
+        op_mod = add_fr1x16(op_mod, multr_fr1x16(last[i], ALEPH_FM_SMOOTH));   \
+        last[i] = op_mod;                                                      \
+                                                                               \
+        phase[i] += freq[i];                                                   \
+                                                                               \
+        next[i] = multr_fr1x16(                                                \
+            env[i], sine_polyblep(phase[i] + shl_fr1x32(op_mod, 20)));         \
+    } while (0)
+
+// All operators read the previous frame, then outputs are shuffled.
+#define ALEPH_FM_ALG_FRAME(mod0, mod1, mod2, mod3)                             \
+    do {                                                                       \
+        fract16 next[ALEPH_FM_ALGORITHM_OPS];                                  \
+                                                                               \
+        ALEPH_FM_ALG_OP(0, mod0);                                              \
+        ALEPH_FM_ALG_OP(1, mod1);                                              \
+        ALEPH_FM_ALG_OP(2, mod2);                                              \
+        ALEPH_FM_ALG_OP(3, mod3);                                              \
+                                                                               \
+        for (i = 0; i < ALEPH_FM_ALGORITHM_OPS; i++) {                         \
+            out[i] = next[i];                                                  \
+            acc[i] = add_fr1x16(shr_fr1x16(next[i], ALEPH_FM_OVERSAMPLE_BITS), \
+                                acc[i]);                                       \
+        }                                                                      \
+    } while (0)
+
+#if ALEPH_FM_OVERSAMPLE == 4
+#define ALEPH_FM_ALG_OVERSAMPLE(frame)                                         \
+    do {                                                                       \
+        frame;                                                                 \
+        frame;                                                                 \
+        frame;                                                                 \
+        frame;                                                                 \
+    } while (0)
+#else
+#define ALEPH_FM_ALG_OVERSAMPLE(frame)                                         \
+    do {                                                                       \
+        int j;                                                                 \
+        for (j = 0; j < ALEPH_FM_OVERSAMPLE; j++) {                            \
+            frame;                                                             \
+        }                                                                      \
+    } while (0)
+#endif
+
+// Define an algorithm kernel from the modulation input of each operator.
+#define ALEPH_FM_ALGORITHM(name, mod0, mod1, mod2, mod3)                       \
+    static void name(t_Aleph_FMVoice *fmv, fract16 *env) {                     \
+                                                                               \
+        fract16 out[ALEPH_FM_ALGORITHM_OPS];                                   \
+        fract16 last[ALEPH_FM_ALGORITHM_OPS];                                  \
+        fract16 acc[ALEPH_FM_ALGORITHM_OPS];                                   \
+        fract16 gain[ALEPH_FM_ALGORITHM_OPS][2];                               \
+        int32_t phase[ALEPH_FM_ALGORITHM_OPS];                                 \
+        fract32 freq[ALEPH_FM_ALGORITHM_OPS];                                  \
+                                                                               \
+        int i;                                                                 \
+        for (i = 0; i < ALEPH_FM_ALGORITHM_OPS; i++) {                         \
+            out[i] = fmv->op_outputs_internal[i];                              \
+            last[i] = fmv->op_mod_last[i];                                     \
+            acc[i] = 0;                                                        \
+            gain[i][0] = fmv->algorithm_gain[i][0];                            \
+            gain[i][1] = fmv->algorithm_gain[i][1];                            \
+            phase[i] = fmv->op_osc[i]->phase;                                  \
+            freq[i] = fmv->op_freqs[i];                                        \
+        }                                                                      \
+                                                                               \
+        /* Unused when nothing is modulated. */                                \
+        (void)gain;                                                            \
+                                                                               \
+        ALEPH_FM_ALG_OVERSAMPLE(ALEPH_FM_ALG_FRAME(mod0, mod1, mod2, mod3));   \
+                                                                               \
+        for (i = 0; i < ALEPH_FM_ALGORITHM_OPS; i++) {                         \
+            fmv->op_outputs_internal[i] = out[i];                              \
+            fmv->op_outputs[i] = acc[i];                                       \
+            fmv->op_mod_last[i] = last[i];                                     \
+            fmv->op_osc[i]->phase = phase[i];                                  \
+        }                                                                      \
+    }
+
 /*----- Typedefs -----------------------------------------------------*/
 
+typedef void (*p_Aleph_FMVoice_algorithm)(t_Aleph_FMVoice *fmv,
+                                          fract16 *env);
+
+typedef struct {
+    // Bit s of mod_mask[i] is set when operator s modulates operator i.
+    uint8_t mod_mask[ALEPH_FM_ALGORITHM_OPS];
+    p_Aleph_FMVoice_algorithm kernel;
+} t_Aleph_FMVoice_algorithm;
+
+typedef void (*p_Aleph_FMVoice_op_kernel)(t_Aleph_FMVoice *fmv, uint8_t i,
+                                          fract16 *env, fract16 *output);
+
 /*----- Static variable definitions ----------------------------------*/
 
 /*----- Extern variable definitions ----------------------------------*/
 
 /*----- Static function prototypes -----------------------------------*/
 
+static void _set_idle(t_Aleph_FMVoice *fmv);
+static void _compile(t_Aleph_FMVoice *fmv);
+static e_Aleph_FMVoice_algorithm _match_algorithm(t_Aleph_FMVoice *fmv);
+static void _add_term(t_Aleph_FMVoice *fmv, uint8_t source, fract16 gain,
+                      uint8_t *term);
+static inline void _op_next(t_Aleph_FMVoice *fmv, uint8_t i, bool band_limit,
+                            bool freq_saturate, fract16 *env,
+                            fract16 *output);
+static void _op_next_plain(t_Aleph_FMVoice *fmv, uint8_t i, fract16 *env,
+                           fract16 *output);
+static void _op_next_bl(t_Aleph_FMVoice *fmv, uint8_t i, fract16 *env,
+                        fract16 *output);
+static void _op_next_fs(t_Aleph_FMVoice *fmv, uint8_t i, fract16 *env,
+                        fract16 *output);
+static void _op_next_bl_fs(t_Aleph_FMVoice *fmv, uint8_t i, fract16 *env,
+                           fract16 *output);
+
+// Kernel table, indexed by band_limit | freq_saturate << 1.
+static const p_Aleph_FMVoice_op_kernel _op_kernels[ALEPH_FM_NUM_KERNELS] = {
+    _op_next_plain, _op_next_bl, _op_next_fs, _op_next_bl_fs};
+
+ALEPH_FM_ALGORITHM(_alg_stack, ALEPH_FM_ALG_MOD_1(0, 1),
+                   ALEPH_FM_ALG_MOD_1(1, 2), ALEPH_FM_ALG_MOD_1(2, 3),
+                   ALEPH_FM_ALG_MOD_0(3))
+
+ALEPH_FM_ALGORITHM(_alg_stack_fb, ALEPH_FM_ALG_MOD_1(0, 1),
+                   ALEPH_FM_ALG_MOD_1(1, 2), ALEPH_FM_ALG_MOD_1(2, 3),
+                   ALEPH_FM_ALG_MOD_1(3, 3))
+
+ALEPH_FM_ALGORITHM(_alg_two_stacks, ALEPH_FM_ALG_MOD_1(0, 1),
+                   ALEPH_FM_ALG_MOD_0(1), ALEPH_FM_ALG_MOD_1(2, 3),
+                   ALEPH_FM_ALG_MOD_0(3))
+
+ALEPH_FM_ALGORITHM(_alg_branch, ALEPH_FM_ALG_MOD_2(0, 1, 2),
+                   ALEPH_FM_ALG_MOD_0(1), ALEPH_FM_ALG_MOD_1(2, 3),
+                   ALEPH_FM_ALG_MOD_0(3))
+
+ALEPH_FM_ALGORITHM(_alg_parallel, ALEPH_FM_ALG_MOD_0(0), ALEPH_FM_ALG_MOD_0(1),
+                   ALEPH_FM_ALG_MOD_0(2), ALEPH_FM_ALG_MOD_0(3))
+
+// Algorithm table, indexed by e_Aleph_FMVoice_algorithm.
+static const t_Aleph_FMVoice_algorithm
+    _algorithms[ALEPH_FM_NUM_ALGORITHMS] = {
+        {{1 << 1, 1 << 2, 1 << 3, 0}, _alg_stack},
+        {{1 << 1, 1 << 2, 1 << 3, 1 << 3}, _alg_stack_fb},
+        {{1 << 1, 0, 1 << 3, 0}, _alg_two_stacks},
+        {{1 << 1 | 1 << 2, 0, 1 << 3, 0}, _alg_branch},
+        {{0, 0, 0, 0}, _alg_parallel},
+};
+
 /*----- Extern function implementations ------------------------------*/
 
 void Aleph_FMVoice_init(Aleph_FMVoice *const fm_voice, t_Aleph *const aleph) {
@@ -68,6 +226,8 @@ void Aleph_FMVoice_init_to_pool(Aleph_FMVoice *const fm_voice,
     fmv->portamento = SLEW_1MS;
     fmv->base_freq = 0;
 
+    Aleph_EnvADSRBank_init_to_pool(&fmv->op_env, fmv->num_ops, mempool);
+
     int i;
     for (i = 0; i < fmv->num_ops; i++) {
         fmv->op_tune[i] = FIX16_ONE;
@@ -90,12 +250,6 @@ void Aleph_FMVoice_init_to_pool(Aleph_FMVoice *const fm_voice,
 
         fmv->op_freqs[i] = 0;
 
-        /// TODO: Either use 16 bit envelope,
-        ///         or have 32 bit outputs.
-        ///         Currently truncating output of 32 bit envelope.
-        //
-        Aleph_EnvADSR_init_to_pool(&(fmv->op_env[i]), mempool);
-
         fmv->op_mod_last[i] = 0;
         fmv->band_limit[i] = 1;
         fmv->freq_saturate[i] = 1;
@@ -104,7 +258,12 @@ void Aleph_FMVoice_init_to_pool(Aleph_FMVoice *const fm_voice,
     for (i = 0; i < ALEPH_FM_MOD_POINTS_MAX; i++) {
         fmv->op_mod_points_external[i] = 0;
         fmv->op_mod_points_last[i] = 0;
+        fmv->op_mod_points[i] = 0;
     }
+
+    fmv->idle = true;
+
+    fmv->dirty = true;
 }
 
 void Aleph_FMVoice_next(Aleph_FMVoice *const fm_voice) {
@@ -115,23 +274,28 @@ void Aleph_FMVoice_next(Aleph_FMVoice *const fm_voice) {
 
     fract16 oversample_outs[ALEPH_FM_OPS_MAX][ALEPH_FM_OVERSAMPLE];
 
-    fract16 mod_points[ALEPH_FM_MOD_POINTS_MAX];
-
     fract32 op_freq_target;
     fract16 env_next[ALEPH_FM_OPS_MAX];
 
-    fract16 op_mod;
-    fract32 op_phase;
-    fract16 osc_signal;
     fract16 next_op_outputs[ALEPH_FM_OPS_MAX];
 
+    // Routing changed since the last sample.
+    if (fmv->dirty) {
+        _compile(fmv);
+    }
+
+    // Outputs were cleared when voice became idle.
+    if (fmv->idle) {
+        return;
+    }
+
     normalised_log_slew(&(fmv->base_freq),
                         fix16_mul_fract(fmv->note_freq, fmv->note_tune),
                         fmv->portamento);
 
-    for (i = 0; i < fmv->num_ops; i++) {
+    Aleph_EnvADSRBank_next(&fmv->op_env, env_next);
 
-        env_next[i] = trunc_fr1x32(Aleph_EnvADSR_next(&(fmv->op_env[i])));
+    for (i = 0; i < fmv->num_ops; i++) {
 
         op_freq_target =
             shr_fr1x32(fix16_mul_fract(fmv->base_freq, fmv->op_tune[i]),
@@ -141,74 +305,29 @@ void Aleph_FMVoice_next(Aleph_FMVoice *const fm_voice) {
                             fmv->op_slew[i]);
     }
 
+    // Every operator has released to silence.
+    if (Aleph_EnvADSRBank_is_idle(&fmv->op_env)) {
+        _set_idle(fmv);
+        return;
+    }
+
+    // Known routing, no schedule or mod points needed.
+    if (fmv->algorithm != ALEPH_FM_ALGORITHM_GENERIC) {
+        _algorithms[fmv->algorithm].kernel(fmv, env_next);
+        return;
+    }
+
+    // Schedule terms point at these.
     for (i = 0; i < fmv->num_mod_points; i++) {
 
-        mod_points[i] = trunc_fr1x32(fmv->op_mod_points_external[i]);
+        fmv->op_mod_points[i] = trunc_fr1x32(fmv->op_mod_points_external[i]);
     }
 
     for (j = 0; j < ALEPH_FM_OVERSAMPLE; j++) {
 
-        // Calculate modulation point & bandLimit to 20khz or so...
+        // Kernels were selected when flags changed.
         for (i = 0; i < fmv->num_ops; i++) {
-
-            // Add first modulation source.
-            if (fmv->op_mod1_source[i] < fmv->num_ops) {
-
-                op_mod = multr_fr1x16(
-                    fmv->op_outputs_internal[fmv->op_mod1_source[i]],
-                    fmv->op_mod1_gain[i]);
-
-            } else {
-                op_mod = multr_fr1x16(
-                    mod_points[fmv->op_mod1_source[i] - fmv->num_ops],
-                    fmv->op_mod1_gain[i]);
-            }
-
-            // Add second modulation source.
-            if (fmv->op_mod2_source[i] < fmv->num_ops) {
-
-                op_mod = add_fr1x16(
-                    op_mod,
-                    multr_fr1x16(
-                        fmv->op_outputs_internal[fmv->op_mod2_source[i]],
-                        fmv->op_mod2_gain[i]));
-
-            } else {
-                op_mod = add_fr1x16(
-                    op_mod,
-                    multr_fr1x16(
-                        mod_points[fmv->op_mod2_source[i] - fmv->num_ops],
-                        fmv->op_mod2_gain[i]));
-            }
-
-            op_mod = shr_fr1x32(op_mod, 2);
-
-            if (fmv->band_limit[i]) {
-
-                // BandLimit modulation signal with 20khz iir.
-                op_mod = mult_fr1x16(op_mod, FR16_MAX - ALEPH_FM_SMOOTH);
-
-                op_mod = add_fr1x16(
-                    op_mod, multr_fr1x16(fmv->op_mod_last[i], ALEPH_FM_SMOOTH));
-
-                fmv->op_mod_last[i] = op_mod;
-            }
-
-            // Phase increment each op with the oversample-compensated
-            // frequency, calculate the op output for next oversampled frame.
-            op_phase =
-                Aleph_Phasor_next_dynamic(&(fmv->op_osc[i]), fmv->op_freqs[i]);
-
-            if (fmv->freq_saturate[i]) {
-
-                op_phase += shl_fr1x32(op_mod, 20);
-
-            } else {
-                op_phase += (op_mod << 20);
-            }
-
-            osc_signal = sine_polyblep(op_phase);
-            next_op_outputs[i] = multr_fr1x16(env_next[i], osc_signal);
+            _op_kernels[fmv->op_kernel[i]](fmv, i, env_next, next_op_outputs);
         }
 
         for (i = 0; i < fmv->num_ops; i++) {
@@ -234,6 +353,18 @@ void Aleph_FMVoice_next(Aleph_FMVoice *const fm_voice) {
     }
 }
 
+e_Aleph_FMVoice_algorithm
+Aleph_FMVoice_get_algorithm(Aleph_FMVoice *const fm_voice) {
+
+    t_Aleph_FMVoice *fmv = *fm_voice;
+
+    if (fmv->dirty) {
+        _compile(fmv);
+    }
+
+    return fmv->algorithm;
+}
+
 void Aleph_FMVoice_set_note_freq(Aleph_FMVoice *const fm_voice, fix16 freq) {
 
     t_Aleph_FMVoice *fmv = *fm_voice;
@@ -252,13 +383,20 @@ void Aleph_FMVoice_set_gate(Aleph_FMVoice *const fm_voice, bool gate) {
 
     t_Aleph_FMVoice *fmv = *fm_voice;
 
-    int i;
-    for (i = 0; i < fmv->num_ops; i++) {
+    Aleph_EnvADSRBank_set_gate(&fmv->op_env, gate);
 
-        Aleph_EnvADSR_set_gate(&(fmv->op_env[i]), gate);
+    if (gate) {
+        fmv->idle = false;
     }
 }
 
+bool Aleph_FMVoice_is_idle(Aleph_FMVoice *const fm_voice) {
+
+    t_Aleph_FMVoice *fmv = *fm_voice;
+
+    return fmv->idle;
+}
+
 void Aleph_FMVoice_set_op_tune(Aleph_FMVoice *const fm_voice, uint8_t op_index,
                                fract32 tune) {
 
@@ -273,6 +411,8 @@ void Aleph_FMVoice_set_op_mod1_gain(Aleph_FMVoice *const fm_voice,
     t_Aleph_FMVoice *fmv = *fm_voice;
 
     fmv->op_mod1_gain[op_index] = gain;
+
+    fmv->dirty = true;
 }
 
 void Aleph_FMVoice_set_op_mod2_gain(Aleph_FMVoice *const fm_voice,
@@ -281,6 +421,48 @@ void Aleph_FMVoice_set_op_mod2_gain(Aleph_FMVoice *const fm_voice,
     t_Aleph_FMVoice *fmv = *fm_voice;
 
     fmv->op_mod2_gain[op_index] = gain;
+
+    fmv->dirty = true;
+}
+
+void Aleph_FMVoice_set_op_mod1_source(Aleph_FMVoice *const fm_voice,
+                                      uint8_t op_index, uint8_t source) {
+
+    t_Aleph_FMVoice *fmv = *fm_voice;
+
+    fmv->op_mod1_source[op_index] = source;
+
+    fmv->dirty = true;
+}
+
+void Aleph_FMVoice_set_op_mod2_source(Aleph_FMVoice *const fm_voice,
+                                      uint8_t op_index, uint8_t source) {
+
+    t_Aleph_FMVoice *fmv = *fm_voice;
+
+    fmv->op_mod2_source[op_index] = source;
+
+    fmv->dirty = true;
+}
+
+void Aleph_FMVoice_set_op_band_limit(Aleph_FMVoice *const fm_voice,
+                                     uint8_t op_index, bool band_limit) {
+
+    t_Aleph_FMVoice *fmv = *fm_voice;
+
+    fmv->band_limit[op_index] = band_limit;
+
+    fmv->dirty = true;
+}
+
+void Aleph_FMVoice_set_op_freq_saturate(Aleph_FMVoice *const fm_voice,
+                                        uint8_t op_index, bool freq_saturate) {
+
+    t_Aleph_FMVoice *fmv = *fm_voice;
+
+    fmv->freq_saturate[op_index] = freq_saturate;
+
+    fmv->dirty = true;
 }
 
 void Aleph_FMVoice_set_op_attack(Aleph_FMVoice *const fm_voice,
@@ -288,7 +470,7 @@ void Aleph_FMVoice_set_op_attack(Aleph_FMVoice *const fm_voice,
 
     t_Aleph_FMVoice *fmv = *fm_voice;
 
-    Aleph_EnvADSR_set_attack(&(fmv->op_env[op_index]), attack);
+    Aleph_EnvADSRBank_set_attack(&fmv->op_env, op_index, attack);
 }
 
 void Aleph_FMVoice_set_op_decay(Aleph_FMVoice *const fm_voice, uint8_t op_index,
@@ -296,7 +478,7 @@ void Aleph_FMVoice_set_op_decay(Aleph_FMVoice *const fm_voice, uint8_t op_index,
 
     t_Aleph_FMVoice *fmv = *fm_voice;
 
-    Aleph_EnvADSR_set_decay(&(fmv->op_env[op_index]), decay);
+    Aleph_EnvADSRBank_set_decay(&fmv->op_env, op_index, decay);
 }
 
 void Aleph_FMVoice_set_op_sustain(Aleph_FMVoice *const fm_voice,
@@ -304,7 +486,7 @@ void Aleph_FMVoice_set_op_sustain(Aleph_FMVoice *const fm_voice,
 
     t_Aleph_FMVoice *fmv = *fm_voice;
 
-    Aleph_EnvADSR_set_sustain(&(fmv->op_env[op_index]), sustain);
+    Aleph_EnvADSRBank_set_sustain(&fmv->op_env, op_index, sustain);
 }
 
 void Aleph_FMVoice_set_op_release(Aleph_FMVoice *const fm_voice,
@@ -312,7 +494,7 @@ void Aleph_FMVoice_set_op_release(Aleph_FMVoice *const fm_voice,
 
     t_Aleph_FMVoice *fmv = *fm_voice;
 
-    Aleph_EnvADSR_set_release(&(fmv->op_env[op_index]), release);
+    Aleph_EnvADSRBank_set_release(&fmv->op_env, op_index, release);
 }
 
 void Aleph_FMVoice_set_portamento(Aleph_FMVoice *const fm_voice,
@@ -325,4 +507,214 @@ void Aleph_FMVoice_set_portamento(Aleph_FMVoice *const fm_voice,
 
 /*----- Static function implementations ------------------------------*/
 
+// Snap envelopes to zero and clear operator feedback and smoothing state.
+static void _set_idle(t_Aleph_FMVoice *fmv) {
+
+    int i;
+
+    fmv->idle = true;
+
+    Aleph_EnvADSRBank_reset(&fmv->op_env);
+
+    for (i = 0; i < fmv->num_ops; i++) {
+
+        fmv->op_outputs[i] = 0;
+        fmv->op_outputs_internal[i] = 0;
+        fmv->op_mod_last[i] = 0;
+    }
+}
+
+// Flatten routing into (source, gain) terms, dropping silent ones, and
+// select each operator's kernel and the voice algorithm.
+static void _compile(t_Aleph_FMVoice *fmv) {
+
+    uint8_t term = 0;
+
+    int i;
+    for (i = 0; i < fmv->num_ops; i++) {
+
+        fmv->sched_start[i] = term;
+
+        _add_term(fmv, fmv->op_mod1_source[i], fmv->op_mod1_gain[i], &term);
+        _add_term(fmv, fmv->op_mod2_source[i], fmv->op_mod2_gain[i], &term);
+
+        fmv->op_kernel[i] =
+            (fmv->band_limit[i] ? ALEPH_FM_KERNEL_BAND_LIMIT : 0) |
+            (fmv->freq_saturate[i] ? ALEPH_FM_KERNEL_FREQ_SATURATE : 0);
+    }
+
+    fmv->sched_start[i] = term;
+
+    fmv->algorithm = _match_algorithm(fmv);
+
+    fmv->dirty = false;
+}
+
+// Find an algorithm with the same routing as the schedule and copy its
+// gains. Mod points, repeated sources or non-default flags fall back to
+// the generic schedule.
+static e_Aleph_FMVoice_algorithm _match_algorithm(t_Aleph_FMVoice *fmv) {
+
+    uint8_t mask[ALEPH_FM_ALGORITHM_OPS];
+    uint8_t source;
+    fract16 gain;
+    int i, k, s;
+
+    if (fmv->num_ops != ALEPH_FM_ALGORITHM_OPS) {
+        return ALEPH_FM_ALGORITHM_GENERIC;
+    }
+
+    for (i = 0; i < ALEPH_FM_ALGORITHM_OPS; i++) {
+
+        if (fmv->op_kernel[i] !=
+            (ALEPH_FM_KERNEL_BAND_LIMIT | ALEPH_FM_KERNEL_FREQ_SATURATE)) {
+            return ALEPH_FM_ALGORITHM_GENERIC;
+        }
+
+        mask[i] = 0;
+
+        for (k = 0; k < 2; k++) {
+
+            source = k ? fmv->op_mod2_source[i] : fmv->op_mod1_source[i];
+            gain = k ? fmv->op_mod2_gain[i] : fmv->op_mod1_gain[i];
+
+            if (gain == 0) {
+                continue;
+            }
+
+            if (source >= ALEPH_FM_ALGORITHM_OPS || mask[i] & 1 << source) {
+                return ALEPH_FM_ALGORITHM_GENERIC;
+            }
+
+            mask[i] |= 1 << source;
+        }
+    }
+
+    for (k = 0; k < ALEPH_FM_NUM_ALGORITHMS; k++) {
+
+        for (i = 0; i < ALEPH_FM_ALGORITHM_OPS; i++) {
+            if (mask[i] != _algorithms[k].mod_mask[i]) {
+                break;
+            }
+        }
+
+        if (i == ALEPH_FM_ALGORITHM_OPS) {
+            break;
+        }
+    }
+
+    if (k == ALEPH_FM_NUM_ALGORITHMS) {
+        return ALEPH_FM_ALGORITHM_GENERIC;
+    }
+
+    for (i = 0; i < ALEPH_FM_ALGORITHM_OPS; i++) {
+
+        uint8_t slot = 0;
+
+        fmv->algorithm_gain[i][0] = 0;
+        fmv->algorithm_gain[i][1] = 0;
+
+        for (s = 0; s < ALEPH_FM_ALGORITHM_OPS; s++) {
+
+            if (!(mask[i] & 1 << s)) {
+                continue;
+            }
+
+            if (fmv->op_mod1_gain[i] != 0 && fmv->op_mod1_source[i] == s) {
+                fmv->algorithm_gain[i][slot++] = fmv->op_mod1_gain[i];
+            } else {
+                fmv->algorithm_gain[i][slot++] = fmv->op_mod2_gain[i];
+            }
+        }
+    }
+
+    return k;
+}
+
+static void _add_term(t_Aleph_FMVoice *fmv, uint8_t source, fract16 gain,
+                      uint8_t *term) {
+
+    // Zero gain adds nothing, out of range sources were never valid.
+    if (gain == 0 || source >= fmv->num_ops + fmv->num_mod_points) {
+        return;
+    }
+
+    if (source < fmv->num_ops) {
+        fmv->sched_src[*term] = &fmv->op_outputs_internal[source];
+    } else {
+        fmv->sched_src[*term] = &fmv->op_mod_points[source - fmv->num_ops];
+    }
+
+    fmv->sched_gain[*term] = gain;
+
+    (*term)++;
+}
+
+// Calculate operator output for the next oversampled frame. Flags are
+// constant in each kernel below, so their branches fold away.
+static inline void _op_next(t_Aleph_FMVoice *fmv, uint8_t i, bool band_limit,
+                            bool freq_saturate, fract16 *env,
+                            fract16 *output) {
+
+    fract16 op_mod = 0;
+    fract32 op_phase;
+
+    int term = fmv->sched_start[i];
+    int end = fmv->sched_start[i + 1];
+
+    for (; term < end; term++) {
+        op_mod = add_fr1x16(op_mod, multr_fr1x16(*fmv->sched_src[term],
+                                                 fmv->sched_gain[term]));
+    }
+
+    op_mod = shr_fr1x32(op_mod, 2);
+
+    if (band_limit) {
+
+        // BandLimit modulation signal with 20khz iir.
+        op_mod = mult_fr1x16(op_mod, FR16_MAX - ALEPH_FM_SMOOTH);
+
+        op_mod = add_fr1x16(op_mod,
+                            multr_fr1x16(fmv->op_mod_last[i], ALEPH_FM_SMOOTH));
+
+        fmv->op_mod_last[i] = op_mod;
+    }
+
+    // Phase increment each op with the oversample-compensated
+    // frequency, calculate the op output for next oversampled frame.
+    op_phase = Aleph_Phasor_next_dynamic(&(fmv->op_osc[i]), fmv->op_freqs[i]);
+
+    if (freq_saturate) {
+        op_phase += shl_fr1x32(op_mod, 20);
+    } else {
+        op_phase += (op_mod << 20);
+    }
+
+    output[i] = multr_fr1x16(env[i], sine_polyblep(op_phase));
+}
+
+static void _op_next_plain(t_Aleph_FMVoice *fmv, uint8_t i, fract16 *env,
+                           fract16 *output) {
+
+    _op_next(fmv, i, false, false, env, output);
+}
+
+static void _op_next_bl(t_Aleph_FMVoice *fmv, uint8_t i, fract16 *env,
+                        fract16 *output) {
+
+    _op_next(fmv, i, true, false, env, output);
+}
+
+static void _op_next_fs(t_Aleph_FMVoice *fmv, uint8_t i, fract16 *env,
+                        fract16 *output) {
+
+    _op_next(fmv, i, false, true, env, output);
+}
+
+static void _op_next_bl_fs(t_Aleph_FMVoice *fmv, uint8_t i, fract16 *env,
+                           fract16 *output) {
+
+    _op_next(fmv, i, true, true, env, output);
+}
+
 /*----- END OF FILE --------------------------------------------------*/
@@ -52,8 +52,27 @@ extern "C" {
 
 #define ALEPH_FM_SMOOTH ((fract16)(FR16_MAX * 0.7))
 
+// Operator kernel index, band_limit | freq_saturate << 1.
+#define ALEPH_FM_KERNEL_BAND_LIMIT (1)
+#define ALEPH_FM_KERNEL_FREQ_SATURATE (2)
+#define ALEPH_FM_NUM_KERNELS (4)
+
+// Specialised algorithm kernels have exactly this many operators.
+#define ALEPH_FM_ALGORITHM_OPS (4)
+
 /*----- Typedefs -----------------------------------------------------*/
 
+// Known routings, 'a > b' means operator a modulates operator b.
+typedef enum {
+    ALEPH_FM_ALGORITHM_STACK,      // 3 > 2 > 1 > 0
+    ALEPH_FM_ALGORITHM_STACK_FB,   // 3 > 2 > 1 > 0, 3 > 3
+    ALEPH_FM_ALGORITHM_TWO_STACKS, // 3 > 2, 1 > 0
+    ALEPH_FM_ALGORITHM_BRANCH,     // 3 > 2 > 0, 1 > 0
+    ALEPH_FM_ALGORITHM_PARALLEL,   // No modulation
+    ALEPH_FM_NUM_ALGORITHMS,
+    ALEPH_FM_ALGORITHM_GENERIC = ALEPH_FM_NUM_ALGORITHMS,
+} e_Aleph_FMVoice_algorithm;
+
 typedef struct {
 
     Mempool mempool;
@@ -67,25 +86,46 @@ typedef struct {
     fract32 portamento;
 
     Aleph_Phasor op_osc[ALEPH_FM_OPS_MAX];
-    Aleph_EnvADSR op_env[ALEPH_FM_OPS_MAX];
+    Aleph_EnvADSRBank op_env;
 
     fract32 op_tune[ALEPH_FM_OPS_MAX];
+
+    // Routing, gains and kernel flags are only read through the schedule.
+    // Use the setters, or set `dirty` after writing these directly.
     uint8_t op_mod1_source[ALEPH_FM_OPS_MAX];
     fract16 op_mod1_gain[ALEPH_FM_OPS_MAX];
     uint8_t op_mod2_source[ALEPH_FM_OPS_MAX];
     fract16 op_mod2_gain[ALEPH_FM_OPS_MAX];
 
+    uint8_t band_limit[ALEPH_FM_OPS_MAX];
+    uint8_t freq_saturate[ALEPH_FM_OPS_MAX];
+
     fract16 op_mod_last[ALEPH_FM_OPS_MAX];
     fract32 op_freqs[ALEPH_FM_OPS_MAX];
     fract32 op_slew[ALEPH_FM_OPS_MAX];
-    uint8_t band_limit[ALEPH_FM_OPS_MAX];
-    uint8_t freq_saturate[ALEPH_FM_OPS_MAX];
 
     fract16 op_outputs_internal[ALEPH_FM_OPS_MAX];
     fract16 op_outputs[ALEPH_FM_OPS_MAX];
 
     fract32 op_mod_points_external[ALEPH_FM_MOD_POINTS_MAX];
     fract32 op_mod_points_last[ALEPH_FM_MOD_POINTS_MAX];
+    fract16 op_mod_points[ALEPH_FM_MOD_POINTS_MAX];
+
+    // Modulation schedule, rebuilt at the start of next when `dirty`.
+    // Terms for operator i are [sched_start[i], sched_start[i + 1]).
+    fract16 *sched_src[ALEPH_FM_OPS_MAX * 2];
+    fract16 sched_gain[ALEPH_FM_OPS_MAX * 2];
+    uint8_t sched_start[ALEPH_FM_OPS_MAX + 1];
+    uint8_t op_kernel[ALEPH_FM_OPS_MAX];
+    bool dirty;
+
+    // Specialised kernel matching the routing, or generic schedule.
+    // Gains are ordered by ascending source operator.
+    e_Aleph_FMVoice_algorithm algorithm;
+    fract16 algorithm_gain[ALEPH_FM_ALGORITHM_OPS][2];
+
+    // All operator envelopes have released to silence.
+    bool idle;
 
 } t_Aleph_FMVoice;
 
@@ -104,6 +144,11 @@ void Aleph_FMVoice_next(Aleph_FMVoice *const fm_voice);
 
 void Aleph_FMVoice_set_gate(Aleph_FMVoice *const fm_voice, bool gate);
 
+bool Aleph_FMVoice_is_idle(Aleph_FMVoice *const fm_voice);
+
+e_Aleph_FMVoice_algorithm
+Aleph_FMVoice_get_algorithm(Aleph_FMVoice *const fm_voice);
+
 void Aleph_FMVoice_set_note_freq(Aleph_FMVoice *const fm_voice, fix16 freq);
 void Aleph_FMVoice_set_note_tune(Aleph_FMVoice *const fm_voice, fix16 tune);
 
@@ -116,6 +161,19 @@ void Aleph_FMVoice_set_op_mod1_gain(Aleph_FMVoice *const fm_voice,
 void Aleph_FMVoice_set_op_mod2_gain(Aleph_FMVoice *const fm_voice,
                                     uint8_t op_index, fract16 gain);
 
+// Sources below num_ops are operators, the rest are external mod points.
+void Aleph_FMVoice_set_op_mod1_source(Aleph_FMVoice *const fm_voice,
+                                      uint8_t op_index, uint8_t source);
+
+void Aleph_FMVoice_set_op_mod2_source(Aleph_FMVoice *const fm_voice,
+                                      uint8_t op_index, uint8_t source);
+
+void Aleph_FMVoice_set_op_band_limit(Aleph_FMVoice *const fm_voice,
+                                     uint8_t op_index, bool band_limit);
+
+void Aleph_FMVoice_set_op_freq_saturate(Aleph_FMVoice *const fm_voice,
+                                        uint8_t op_index, bool freq_saturate);
+
 void Aleph_FMVoice_set_op_attack(Aleph_FMVoice *const fm_voice,
                                  uint8_t op_index, fract32 attack);
 
@@ -41,6 +41,8 @@
 
 /*----- Static function prototypes -----------------------------------*/
 
+static inline void _fill_block(fract32 *output, fract32 value, size_t size);
+
 /*----- Extern function implementations ------------------------------*/
 
 /*----- Static function implementations ------------------------------*/
@@ -173,11 +175,211 @@ void normalised_log_slew(fract32 *current, fract32 target, fract32 speed) {
 
 void normalised_log_slew_16(fract16 *current, fract16 target, fract16 speed) {
 
-    fract16 ratio = FR32_MAX - speed;
+    fract16 ratio = FR16_MAX - speed;
     fract16 difference = sub_fr1x16(target, *current);
     int radix = norm_fr1x16(difference);
     fract16 inc = mult_fr1x16(ratio, shl_fr1x16(difference, radix));
-    *current = add_fr1x16(*current, shr_fr1x16(inc, radix));
+
+    inc = shr_fr1x16(inc, radix);
+
+    // Truncation stalls short of a higher target, step at least one LSB.
+    if (inc == 0 && difference > 0) {
+        inc = 1;
+    }
+
+    *current = add_fr1x16(*current, inc);
+}
+
+void Aleph_RadixLinSlew_next_block(t_Aleph_RadixLinSlew *slew,
+                                   fract32 *current, fract32 target,
+                                   fract32 *output, size_t size) {
+
+    fract32 last;
+    fract32 last_remainder;
+
+    int i = 0;
+    while (i < size) {
+
+        last = *current;
+        last_remainder = slew->remainder;
+
+        Aleph_RadixLinSlew_next(slew, current, target);
+        output[i++] = *current;
+
+        if (*current == last && slew->remainder == last_remainder) {
+            break;
+        }
+    }
+
+    _fill_block(&output[i], *current, size - i);
+}
+
+void LinSlew_next_block(t_Aleph_LinSlew *slew, fract32 *current,
+                        fract32 target, fract32 *output, size_t size) {
+
+    int i = 0;
+    while (i < size && *current != target) {
+
+        LinSlew_next(slew, current, target);
+        output[i++] = *current;
+    }
+
+    _fill_block(&output[i], *current, size - i);
+}
+
+void Aleph_AsymLinSlew_next_block(t_Aleph_AsymLinSlew *slew, fract32 *current,
+                                  fract32 target, fract32 *output,
+                                  size_t size) {
+
+    int i = 0;
+    while (i < size && *current != target) {
+
+        Aleph_AsymLinSlew_next(slew, current, target);
+        output[i++] = *current;
+    }
+
+    _fill_block(&output[i], *current, size - i);
+}
+
+void Aleph_RadixLogSlew_next_block(t_Aleph_RadixLogSlew *slew,
+                                   fract32 *current, fract32 target,
+                                   fract32 *output, size_t size) {
+
+    fract32 last;
+    fract32 last_remainder;
+
+    int i = 0;
+    while (i < size) {
+
+        last = *current;
+        last_remainder = slew->remainder;
+
+        Aleph_RadixLogSlew_next(slew, current, target);
+        output[i++] = *current;
+
+        if (*current == last && slew->remainder == last_remainder) {
+            break;
+        }
+    }
+
+    _fill_block(&output[i], *current, size - i);
+}
+
+void fine_log_slew_block(fract32 *current, fract32 target, fract32 speed,
+                         fract32 *output, size_t size) {
+
+    fract32 last;
+
+    int i = 0;
+    while (i < size) {
+
+        last = *current;
+
+        fine_log_slew(current, target, speed);
+        output[i++] = *current;
+
+        if (*current == last) {
+            break;
+        }
+    }
+
+    _fill_block(&output[i], *current, size - i);
+}
+
+void coarse_log_slew_block(fract32 *current, fract32 target, fract32 speed,
+                           fract32 *output, size_t size) {
+
+    fract32 last;
+
+    int i = 0;
+    while (i < size) {
+
+        last = *current;
+
+        coarse_log_slew(current, target, speed);
+        output[i++] = *current;
+
+        if (*current == last) {
+            break;
+        }
+    }
+
+    _fill_block(&output[i], *current, size - i);
+}
+
+void normalised_log_slew_block(fract32 *current, fract32 target,
+                               fract32 speed, fract32 *output, size_t size) {
+
+    fract32 last;
+
+    int i = 0;
+    while (i < size) {
+
+        last = *current;
+
+        normalised_log_slew(current, target, speed);
+        output[i++] = *current;
+
+        if (*current == last) {
+            break;
+        }
+    }
+
+    _fill_block(&output[i], *current, size - i);
+}
+
+void normalised_log_slew_16_block(fract16 *current, fract16 target,
+                                  fract16 speed, fract16 *output,
+                                  size_t size) {
+
+    fract16 last;
+
+    int i = 0;
+    while (i < size) {
+
+        last = *current;
+
+        normalised_log_slew_16(current, target, speed);
+        output[i++] = *current;
+
+        if (*current == last) {
+            break;
+        }
+    }
+
+    for (; i < size; i++) {
+        output[i] = *current;
+    }
+}
+
+void Aleph_Ramp_init(t_Aleph_Ramp *ramp, fract32 start, fract32 end,
+                     size_t size) {
+
+    int64_t diff = (int64_t)end - start;
+    int64_t inc = 0;
+
+    // Round to nearest, difference may exceed fract32 range.
+    if (size > 0) {
+        inc = (diff + (diff < 0 ? -(int64_t)size : (int64_t)size) / 2) /
+              (int64_t)size;
+    }
+
+    if (inc > FR32_MAX) {
+        inc = FR32_MAX;
+    } else if (inc < FR32_MIN) {
+        inc = FR32_MIN;
+    }
+
+    ramp->start = start;
+    ramp->inc = (fract32)inc;
+}
+
+static inline void _fill_block(fract32 *output, fract32 value, size_t size) {
+
+    int i;
+    for (i = 0; i < size; i++) {
+        output[i] = value;
+    }
 }
 
 /*----- End of file --------------------------------------------------*/
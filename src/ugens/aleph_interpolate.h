@@ -86,6 +86,13 @@ typedef struct {
     fract32 rate;
 } t_Aleph_LinSlew;
 
+// Linear parameter ramp over one block, replaces a per sample buffer.
+// Sample i of the block is start + inc * (i + 1).
+typedef struct {
+    fract32 start; // value before the first sample
+    fract32 inc;   // per sample increment
+} t_Aleph_Ramp;
+
 /*----- Extern variable declarations ---------------------------------*/
 
 /*----- Extern function prototypes -----------------------------------*/
@@ -120,6 +127,43 @@ void coarse_log_slew(fract32 *current, fract32 target, fract32 speed);
 void normalised_log_slew(fract32 *current, fract32 target, fract32 speed);
 void normalised_log_slew_16(fract16 *current, fract16 target, fract16 speed);
 
+// Block forms write each step to output, same as calling the per sample
+// function size times. Once a step leaves the slew state unchanged the
+// rest of the block is filled with the converged value.
+
+void Aleph_RadixLinSlew_next_block(t_Aleph_RadixLinSlew *slew,
+                                   fract32 *current, fract32 target,
+                                   fract32 *output, size_t size);
+
+void LinSlew_next_block(t_Aleph_LinSlew *slew, fract32 *current,
+                        fract32 target, fract32 *output, size_t size);
+
+void Aleph_AsymLinSlew_next_block(t_Aleph_AsymLinSlew *slew, fract32 *current,
+                                  fract32 target, fract32 *output,
+                                  size_t size);
+
+void Aleph_RadixLogSlew_next_block(t_Aleph_RadixLogSlew *slew,
+                                   fract32 *current, fract32 target,
+                                   fract32 *output, size_t size);
+
+void fine_log_slew_block(fract32 *current, fract32 target, fract32 speed,
+                         fract32 *output, size_t size);
+
+void coarse_log_slew_block(fract32 *current, fract32 target, fract32 speed,
+                           fract32 *output, size_t size);
+
+void normalised_log_slew_block(fract32 *current, fract32 target,
+                               fract32 speed, fract32 *output, size_t size);
+void normalised_log_slew_16_block(fract16 *current, fract16 target,
+                                  fract16 speed, fract16 *output,
+                                  size_t size);
+
+// Ramp from start towards end over size samples. The increment is rounded,
+// so the last sample lands within size / 2 LSB of end. A step larger than
+// fract32 range saturates and the ramp stops short of end.
+void Aleph_Ramp_init(t_Aleph_Ramp *ramp, fract32 start, fract32 end,
+                     size_t size);
+
 float interp_bspline_float(float x, float _y, float y, float y_, float y__);
 
 /*----- Static function implementations ------------------------------*/
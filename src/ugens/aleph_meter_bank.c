@@ -0,0 +1,225 @@
+/*----------------------------------------------------------------------
+
+                     This file is part of Aleph DSP
+
+                https://github.com/bangcorrupt/aleph-dsp
+
+         Aleph DSP is based on monome/aleph and spiricom/LEAF.
+
+                              MIT License
+
+            Aleph dedicated to the public domain by monome.
+
+                LEAF Copyright Jeff Snyder et. al. 2020
+
+                       Copyright bangcorrupt 2024
+
+----------------------------------------------------------------------*/
+/**
+ * @file    aleph_meter_bank.c
+ *
+ * @brief   Multichannel level metering.
+ *
+ *          Snapshots are double buffered. Publishing writes the back
+ *          buffer, bumps the sequence count and flips the front index, so
+ *          a reader interrupted by the audio loop can detect it and retry.
+ */
+
+/*----- Includes -----------------------------------------------------*/
+
+#include "aleph.h"
+
+#include "aleph_meter_bank.h"
+#include "aleph_utils.h"
+
+/*----- Macros -------------------------------------------------------*/
+
+// Snapshots are not volatile, keep the compiler from moving their loads
+// and stores across the sequence count.
+#define METER_BANK_BARRIER() __asm__ volatile("" ::: "memory")
+
+/*----- Typedefs -----------------------------------------------------*/
+
+/*----- Static variable definitions ----------------------------------*/
+
+/*----- Extern variable definitions ----------------------------------*/
+
+/*----- Static function prototypes -----------------------------------*/
+
+static void _publish(t_Aleph_MeterBank *mb);
+
+/*----- Extern function implementations ------------------------------*/
+
+void Aleph_MeterBank_init(Aleph_MeterBank *const bank, uint8_t num_channels,
+                          t_Aleph *const aleph) {
+
+    Aleph_MeterBank_init_to_pool(bank, num_channels, &aleph->mempool);
+}
+
+void Aleph_MeterBank_init_to_pool(Aleph_MeterBank *const bank,
+                                  uint8_t num_channels,
+                                  Mempool *const mempool) {
+
+    t_Mempool *mp = *mempool;
+
+    t_Aleph_MeterBank *mb = *bank =
+        (t_Aleph_MeterBank *)mpool_calloc(sizeof(t_Aleph_MeterBank), mp);
+
+    mb->mempool = mp;
+
+    if (num_channels > ALEPH_METER_BANK_MAX_CHANNELS) {
+        num_channels = ALEPH_METER_BANK_MAX_CHANNELS;
+    }
+
+    mb->num_channels = num_channels;
+
+    mb->rms_coeff = ALEPH_METER_BANK_DEFAULT_RMS_COEFF;
+    mb->peak_decay = ALEPH_METER_BANK_DEFAULT_PEAK_DECAY;
+    mb->peak_hold = ALEPH_METER_BANK_DEFAULT_PEAK_HOLD;
+
+    Aleph_MeterBank_reset(bank);
+}
+
+void Aleph_MeterBank_free(Aleph_MeterBank *const bank) {
+
+    t_Aleph_MeterBank *mb = *bank;
+
+    mpool_free((char *)mb, mb->mempool);
+}
+
+void Aleph_MeterBank_reset(Aleph_MeterBank *const bank) {
+
+    t_Aleph_MeterBank *mb = *bank;
+
+    int i;
+    for (i = 0; i < ALEPH_METER_BANK_MAX_CHANNELS; i++) {
+        mb->peak[i] = 0;
+        mb->hold_count[i] = 0;
+        mb->mean_square[i] = 0;
+        mb->clips[i] = 0;
+    }
+
+    mb->blocks = 0;
+
+    _publish(mb);
+}
+
+void Aleph_MeterBank_next_block(Aleph_MeterBank *const bank, fract32 **input,
+                                size_t size) {
+
+    t_Aleph_MeterBank *mb = *bank;
+
+    fract32 *in;
+    fract32 x;
+    fract32 peak;
+    fract32 mean_square;
+    int64_t sum;
+    uint32_t clips;
+
+    int c, i;
+    for (c = 0; c < mb->num_channels; c++) {
+
+        in = input[c];
+        peak = 0;
+        sum = 0;
+        clips = 0;
+
+        // One pass for peak, energy and clips.
+        for (i = 0; i < size; i++) {
+
+            x = abs_fr1x32(in[i]);
+
+            peak = max_fr1x32(peak, x);
+            sum += mult_fr1x32x32(x, x);
+
+            if (x >= ALEPH_METER_BANK_CLIP_THRESHOLD) {
+                clips++;
+            }
+        }
+
+        mb->clips[c] += clips;
+
+        // Peak hold, then decay.
+        if (peak >= mb->peak[c]) {
+            mb->peak[c] = peak;
+            mb->hold_count[c] = mb->peak_hold;
+        } else if (mb->hold_count[c] > 0) {
+            mb->hold_count[c]--;
+        } else {
+            mb->peak[c] = max_fr1x32(peak, mult_fr1x32x32(mb->peak[c],
+                                                          mb->peak_decay));
+        }
+
+        // Block mean square, smoothed across blocks.
+        mean_square = size > 0 ? (fract32)(sum / (int64_t)size) : 0;
+
+        mb->mean_square[c] = add_fr1x32(
+            mb->mean_square[c],
+            mult_fr1x32x32(mb->rms_coeff,
+                           sub_fr1x32(mean_square, mb->mean_square[c])));
+    }
+
+    mb->blocks++;
+
+    _publish(mb);
+}
+
+void Aleph_MeterBank_read(Aleph_MeterBank *const bank,
+                          t_Aleph_MeterSnapshot *snapshot) {
+
+    t_Aleph_MeterBank *mb = *bank;
+
+    uint32_t sequence;
+
+    // Retry if a publish landed during the copy.
+    do {
+        sequence = mb->sequence;
+        METER_BANK_BARRIER();
+        *snapshot = mb->snapshot[mb->front];
+        METER_BANK_BARRIER();
+    } while (sequence != mb->sequence);
+}
+
+void Aleph_MeterBank_set_rms_coeff(Aleph_MeterBank *const bank,
+                                   fract32 coeff) {
+
+    t_Aleph_MeterBank *mb = *bank;
+
+    mb->rms_coeff = coeff;
+}
+
+void Aleph_MeterBank_set_peak_hold(Aleph_MeterBank *const bank,
+                                   uint16_t hold, fract32 decay) {
+
+    t_Aleph_MeterBank *mb = *bank;
+
+    mb->peak_hold = hold;
+    mb->peak_decay = decay;
+}
+
+/*----- Static function implementations ------------------------------*/
+
+static void _publish(t_Aleph_MeterBank *mb) {
+
+    uint8_t back = mb->front ^ 1;
+    t_Aleph_MeterSnapshot *snap = &mb->snapshot[back];
+
+    int c;
+    for (c = 0; c < mb->num_channels; c++) {
+
+        snap->peak[c] = mb->peak[c];
+        snap->clips[c] = mb->clips[c];
+
+        // sqrt(mean_square / 2^31) * 2^31, once per channel per block.
+        snap->rms[c] = (fract32)isqrt_64((uint64_t)mb->mean_square[c] << 31);
+    }
+
+    snap->blocks = mb->blocks;
+
+    METER_BANK_BARRIER();
+
+    mb->sequence++;
+    mb->front = back;
+}
+
+/*----- End of file --------------------------------------------------*/
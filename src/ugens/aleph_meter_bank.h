@@ -0,0 +1,111 @@
+/*----------------------------------------------------------------------
+
+                     This file is part of Aleph DSP
+
+                https://github.com/bangcorrupt/aleph-dsp
+
+         Aleph DSP is based on monome/aleph and spiricom/LEAF.
+
+                              MIT License
+
+            Aleph dedicated to the public domain by monome.
+
+                LEAF Copyright Jeff Snyder et. al. 2020
+
+                       Copyright bangcorrupt 2024
+
+----------------------------------------------------------------------*/
+/**
+ * @file    aleph_meter_bank.h
+ *
+ * @brief   Public API for multichannel level metering.
+ *
+ *          Audio side calls next_block once per block. Control side calls
+ *          read, which copies the last published snapshot and never
+ *          blocks the audio loop.
+ */
+
+#ifndef ALEPH_METER_BANK_H
+#define ALEPH_METER_BANK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*----- Includes -----------------------------------------------------*/
+
+#include "aleph.h"
+
+/*----- Macros -------------------------------------------------------*/
+
+#define ALEPH_METER_BANK_MAX_CHANNELS (8)
+
+// Samples at or above this magnitude count as clipped.
+#define ALEPH_METER_BANK_CLIP_THRESHOLD (0x7FFF0000)
+
+// Per block coefficients, about 170 ms with 32 sample blocks at 48 kHz.
+#define ALEPH_METER_BANK_DEFAULT_RMS_COEFF (FR32_MAX >> 8)
+#define ALEPH_METER_BANK_DEFAULT_PEAK_DECAY (FR32_MAX - (FR32_MAX >> 8))
+#define ALEPH_METER_BANK_DEFAULT_PEAK_HOLD (750)
+
+/*----- Typedefs -----------------------------------------------------*/
+
+typedef struct {
+    fract32 peak[ALEPH_METER_BANK_MAX_CHANNELS];
+    fract32 rms[ALEPH_METER_BANK_MAX_CHANNELS];
+    uint32_t clips[ALEPH_METER_BANK_MAX_CHANNELS]; // Wraps, compare deltas.
+    uint32_t blocks;
+} t_Aleph_MeterSnapshot;
+
+typedef struct {
+    Mempool mempool;
+    uint8_t num_channels;
+    fract32 rms_coeff;
+    fract32 peak_decay;
+    uint16_t peak_hold;
+    fract32 peak[ALEPH_METER_BANK_MAX_CHANNELS];
+    uint16_t hold_count[ALEPH_METER_BANK_MAX_CHANNELS];
+    fract32 mean_square[ALEPH_METER_BANK_MAX_CHANNELS];
+    uint32_t clips[ALEPH_METER_BANK_MAX_CHANNELS];
+    uint32_t blocks;
+    t_Aleph_MeterSnapshot snapshot[2];
+    volatile uint8_t front;
+    volatile uint32_t sequence;
+} t_Aleph_MeterBank;
+
+typedef t_Aleph_MeterBank *Aleph_MeterBank;
+
+/*----- Extern variable declarations ---------------------------------*/
+
+/*----- Extern function prototypes -----------------------------------*/
+
+void Aleph_MeterBank_init(Aleph_MeterBank *const bank, uint8_t num_channels,
+                          t_Aleph *const aleph);
+void Aleph_MeterBank_init_to_pool(Aleph_MeterBank *const bank,
+                                  uint8_t num_channels,
+                                  Mempool *const mempool);
+void Aleph_MeterBank_free(Aleph_MeterBank *const bank);
+
+void Aleph_MeterBank_reset(Aleph_MeterBank *const bank);
+
+// One buffer per channel, measures and publishes a snapshot.
+void Aleph_MeterBank_next_block(Aleph_MeterBank *const bank, fract32 **input,
+                                size_t size);
+
+// Copy the latest snapshot, safe to call from the control side.
+void Aleph_MeterBank_read(Aleph_MeterBank *const bank,
+                          t_Aleph_MeterSnapshot *snapshot);
+
+void Aleph_MeterBank_set_rms_coeff(Aleph_MeterBank *const bank,
+                                   fract32 coeff);
+
+// Hold in blocks, then decay by peak_decay per block.
+void Aleph_MeterBank_set_peak_hold(Aleph_MeterBank *const bank,
+                                   uint16_t hold, fract32 decay);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+/*----- End of file --------------------------------------------------*/
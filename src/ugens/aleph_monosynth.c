@@ -29,8 +29,8 @@
 #include "aleph_env_adsr.h"
 #include "aleph_filter.h"
 #include "aleph_filter_svf.h"
-#include "aleph_lpf_one_pole.h"
 #include "aleph_oscillator.h"
+#include "aleph_smoother_bank.h"
 #include "aleph_waveform.h"
 
 #include "aleph_monosynth.h"
@@ -45,6 +45,12 @@
 
 /*----- Static function prototypes -----------------------------------*/
 
+static void _set_idle(t_Aleph_MonoSynth *syn);
+static void _render_block(t_Aleph_MonoSynth *syn, fract32 *output,
+                          size_t size);
+static void _set_smoother(t_Aleph_MonoSynth *syn,
+                          e_Aleph_MonoSynth_smoother smoother, fract32 value);
+
 /*----- Extern function implementations ------------------------------*/
 
 void Aleph_MonoSynth_init(Aleph_MonoSynth *const synth, t_Aleph *const aleph) {
@@ -76,12 +82,17 @@ void Aleph_MonoSynth_init_to_pool(Aleph_MonoSynth *const synth,
 
     syn->phase_reset = ALEPH_MONOSYNTH_DEFAULT_PHASE_RESET;
 
+    syn->idle = true;
+
     Aleph_WaveformDual_init_to_pool(&syn->waveform, mempool);
 
     Aleph_FilterSVF_init_to_pool(&syn->filter, mempool);
 
     Aleph_HPF_init_to_pool(&syn->dc_block, mempool);
 
+    // Block kernels fuse DC blocking into the filter loop.
+    Aleph_FilterSVF_set_dc_block(&syn->filter, &syn->dc_block);
+
     Aleph_EnvADSR_init_to_pool(&syn->amp_env, mempool);
     Aleph_EnvADSR_init_to_pool(&syn->filter_env, mempool);
     Aleph_EnvADSR_init_to_pool(&syn->pitch_env, mempool);
@@ -90,21 +101,30 @@ void Aleph_MonoSynth_init_to_pool(Aleph_MonoSynth *const synth,
     Aleph_Oscillator_init_to_pool(&syn->filter_lfo, mempool);
     Aleph_Oscillator_init_to_pool(&syn->pitch_lfo, mempool);
 
-    Aleph_LPFOnePole_init_to_pool(&syn->amp_slew, mempool);
-    Aleph_LPFOnePole_set_output(&syn->amp_slew, syn->amp);
+    Aleph_SmootherBank_init_to_pool(&syn->smoothers,
+                                    ALEPH_MONOSYNTH_NUM_SMOOTHERS, mempool);
+
+    syn->scratch = (fract32 *)mpool_calloc(
+        sizeof(fract32) * ALEPH_MONOSYNTH_BLOCK_SIZE * 3, mp);
 
-    Aleph_LPFOnePole_init_to_pool(&syn->freq_slew, mempool);
-    Aleph_LPFOnePole_set_output(&syn->freq_slew, syn->freq);
+    syn->block_freq = syn->freq;
+    syn->block_amp_lfo = 0;
 
-    Aleph_LPFOnePole_init_to_pool(&syn->freq_offset_slew, mempool);
-    Aleph_LPFOnePole_set_output(&syn->freq_offset_slew, syn->freq_offset);
+    syn->cutoff = ALEPH_MONOSYNTH_DEFAULT_CUTOFF;
+    syn->res = ALEPH_MONOSYNTH_DEFAULT_RES;
 
-    Aleph_LPFOnePole_init_to_pool(&syn->cutoff_slew, mempool);
-    Aleph_LPFOnePole_set_output(&syn->cutoff_slew,
-                                ALEPH_MONOSYNTH_DEFAULT_CUTOFF);
+    Aleph_FilterSVF_set_coeff(&syn->filter, syn->cutoff);
+    Aleph_FilterSVF_set_rq(&syn->filter, syn->res);
 
-    Aleph_LPFOnePole_init_to_pool(&syn->res_slew, mempool);
-    Aleph_LPFOnePole_set_output(&syn->res_slew, ALEPH_MONOSYNTH_DEFAULT_RES);
+    syn->amp = 0;
+
+    _set_smoother(syn, ALEPH_MONOSYNTH_SMOOTHER_AMP, syn->amp);
+    _set_smoother(syn, ALEPH_MONOSYNTH_SMOOTHER_FREQ, syn->freq);
+    _set_smoother(syn, ALEPH_MONOSYNTH_SMOOTHER_FREQ_OFFSET, syn->freq_offset);
+    _set_smoother(syn, ALEPH_MONOSYNTH_SMOOTHER_CUTOFF,
+                  ALEPH_MONOSYNTH_DEFAULT_CUTOFF);
+    _set_smoother(syn, ALEPH_MONOSYNTH_SMOOTHER_RES,
+                  ALEPH_MONOSYNTH_DEFAULT_RES);
 }
 
 void Aleph_MonoSynth_free(Aleph_MonoSynth *const synth) {
@@ -125,11 +145,9 @@ void Aleph_MonoSynth_free(Aleph_MonoSynth *const synth) {
     Aleph_Oscillator_free(&syn->filter_lfo);
     Aleph_Oscillator_free(&syn->pitch_lfo);
 
-    Aleph_LPFOnePole_free(&syn->freq_slew);
-    Aleph_LPFOnePole_free(&syn->freq_offset_slew);
-    Aleph_LPFOnePole_free(&syn->cutoff_slew);
-    Aleph_LPFOnePole_free(&syn->res_slew);
+    Aleph_SmootherBank_free(&syn->smoothers);
 
+    mpool_free((char *)syn->scratch, syn->mempool);
     mpool_free((char *)syn, syn->mempool);
 }
 
@@ -153,6 +171,14 @@ fract32 Aleph_MonoSynth_next(Aleph_MonoSynth *const synth) {
     fract32 cutoff;
     fract32 res;
 
+    // Skip rendering until next gate.
+    if (syn->idle) {
+        return 0;
+    }
+
+    // Advance parameter smoothers still converging.
+    Aleph_SmootherBank_next(&syn->smoothers);
+
     // Calculate pitch LFO.
     pitch_lfo = Aleph_Oscillator_next(&syn->pitch_lfo);
 
@@ -174,6 +200,12 @@ fract32 Aleph_MonoSynth_next(Aleph_MonoSynth *const synth) {
     // Calculate amplitude envelope.
     amp_env = Aleph_EnvADSR_next(&syn->amp_env);
 
+    // Released to silence.
+    if (Aleph_EnvADSR_is_idle(&syn->amp_env)) {
+        _set_idle(syn);
+        return 0;
+    }
+
     // Scale amplitude envelope.
     amp_env = mult_fr1x32x32(amp_env, syn->amp_env_depth);
 
@@ -190,10 +222,12 @@ fract32 Aleph_MonoSynth_next(Aleph_MonoSynth *const synth) {
     filter_env = mult_fr1x32x32(filter_env, syn->filter_env_depth);
 
     // Get slewed frequency.
-    freq = Aleph_LPFOnePole_next(&syn->freq_slew);
+    freq = Aleph_SmootherBank_get(&syn->smoothers,
+                                  ALEPH_MONOSYNTH_SMOOTHER_FREQ);
 
     // Get slewed frequency offset.
-    freq_offset = Aleph_LPFOnePole_next(&syn->freq_offset_slew);
+    freq_offset = Aleph_SmootherBank_get(&syn->smoothers,
+                                         ALEPH_MONOSYNTH_SMOOTHER_FREQ_OFFSET);
 
     // Apply pitch envelope.
     freq = add_fr1x32(pitch_env, freq);
@@ -221,10 +255,11 @@ fract32 Aleph_MonoSynth_next(Aleph_MonoSynth *const synth) {
     output = add_fr1x32(output, mult_fr1x32x32(output, amp_lfo));
 
     // Get slewed cutoff.
-    cutoff = Aleph_LPFOnePole_next(&syn->cutoff_slew);
+    cutoff = Aleph_SmootherBank_get(&syn->smoothers,
+                                    ALEPH_MONOSYNTH_SMOOTHER_CUTOFF);
 
     // Get slewed resonance.
-    res = Aleph_LPFOnePole_next(&syn->res_slew);
+    res = Aleph_SmootherBank_get(&syn->smoothers, ALEPH_MONOSYNTH_SMOOTHER_RES);
 
     // Apply filter envelope.
     cutoff = add_fr1x32(filter_env, cutoff);
@@ -236,6 +271,9 @@ fract32 Aleph_MonoSynth_next(Aleph_MonoSynth *const synth) {
     Aleph_FilterSVF_set_coeff(&syn->filter, cutoff);
     Aleph_FilterSVF_set_rq(&syn->filter, res);
 
+    syn->cutoff = cutoff;
+    syn->res = res;
+
     // Apply filter.
     switch (syn->filter_type) {
 
@@ -263,6 +301,34 @@ fract32 Aleph_MonoSynth_next(Aleph_MonoSynth *const synth) {
     return output;
 }
 
+void Aleph_MonoSynth_next_block(Aleph_MonoSynth *const synth, fract32 *output,
+                                size_t size) {
+
+    t_Aleph_MonoSynth *syn = *synth;
+
+    size_t block;
+
+    int i;
+
+    while (size > 0) {
+
+        block = size < ALEPH_MONOSYNTH_BLOCK_SIZE ? size
+                                                  : ALEPH_MONOSYNTH_BLOCK_SIZE;
+
+        // Skip rendering until next gate.
+        if (syn->idle) {
+            for (i = 0; i < block; i++) {
+                output[i] = 0;
+            }
+        } else {
+            _render_block(syn, output, block);
+        }
+
+        output += block;
+        size -= block;
+    }
+}
+
 void Aleph_MonoSynth_set_shape(Aleph_MonoSynth *const synth,
                                e_Aleph_Waveform_shape shape) {
 
@@ -276,7 +342,8 @@ void Aleph_MonoSynth_set_amp(Aleph_MonoSynth *const synth, fract32 amp) {
     t_Aleph_MonoSynth *syn = *synth;
 
     syn->amp = amp;
-    // Aleph_LPFOnePole_set_target(&syn->amp_slew, syn->amp);
+    // Aleph_SmootherBank_set_target(&syn->smoothers,
+    //                               ALEPH_MONOSYNTH_SMOOTHER_AMP, amp);
 }
 
 void Aleph_MonoSynth_set_phase(Aleph_MonoSynth *const synth, fract32 phase) {
@@ -290,7 +357,8 @@ void Aleph_MonoSynth_set_freq(Aleph_MonoSynth *const synth, fract32 freq) {
 
     t_Aleph_MonoSynth *syn = *synth;
 
-    Aleph_LPFOnePole_set_target(&syn->freq_slew, freq);
+    Aleph_SmootherBank_set_target(&syn->smoothers,
+                                  ALEPH_MONOSYNTH_SMOOTHER_FREQ, freq);
 }
 
 void Aleph_MonoSynth_set_freq_offset(Aleph_MonoSynth *const synth,
@@ -298,7 +366,9 @@ void Aleph_MonoSynth_set_freq_offset(Aleph_MonoSynth *const synth,
 
     t_Aleph_MonoSynth *syn = *synth;
 
-    // Aleph_LPFOnePole_set_target(&syn->freq_offset_slew, freq_offset);
+    // Aleph_SmootherBank_set_target(&syn->smoothers,
+    //                               ALEPH_MONOSYNTH_SMOOTHER_FREQ_OFFSET,
+    //                               freq_offset);
     syn->freq_offset = freq_offset;
 }
 
@@ -314,14 +384,16 @@ void Aleph_MonoSynth_set_cutoff(Aleph_MonoSynth *const synth, fract32 cutoff) {
 
     t_Aleph_MonoSynth *syn = *synth;
 
-    Aleph_LPFOnePole_set_target(&syn->cutoff_slew, cutoff);
+    Aleph_SmootherBank_set_target(&syn->smoothers,
+                                  ALEPH_MONOSYNTH_SMOOTHER_CUTOFF, cutoff);
 }
 
 void Aleph_MonoSynth_set_res(Aleph_MonoSynth *const synth, fract32 res) {
 
     t_Aleph_MonoSynth *syn = *synth;
 
-    Aleph_LPFOnePole_set_target(&syn->res_slew, res);
+    Aleph_SmootherBank_set_target(&syn->smoothers,
+                                  ALEPH_MONOSYNTH_SMOOTHER_RES, res);
 }
 
 void Aleph_MonoSynth_set_amp_env_attack(Aleph_MonoSynth *const synth,
@@ -507,11 +579,210 @@ void Aleph_MonoSynth_set_gate(Aleph_MonoSynth *const synth, bool gate) {
         Aleph_WaveformDual_set_phase(&syn->waveform, 0);
     }
 
+    if (gate && syn->idle) {
+
+        // Start the block frequency ramp at pitch, not from the last note.
+        syn->block_freq = Aleph_SmootherBank_get(
+            &syn->smoothers, ALEPH_MONOSYNTH_SMOOTHER_FREQ);
+    }
+
+    if (gate) {
+        syn->idle = false;
+    }
+
     Aleph_EnvADSR_set_gate(&syn->amp_env, gate);
     Aleph_EnvADSR_set_gate(&syn->filter_env, gate);
     Aleph_EnvADSR_set_gate(&syn->pitch_env, gate);
 }
 
+bool Aleph_MonoSynth_is_idle(Aleph_MonoSynth *const synth) {
+
+    t_Aleph_MonoSynth *syn = *synth;
+
+    return syn->idle;
+}
+
+void Aleph_MonoSynth_reset(Aleph_MonoSynth *const synth) {
+
+    t_Aleph_MonoSynth *syn = *synth;
+
+    _set_idle(syn);
+}
+
+fract32 Aleph_MonoSynth_get_level(Aleph_MonoSynth *const synth) {
+
+    t_Aleph_MonoSynth *syn = *synth;
+
+    return syn->amp_env->env_out;
+}
+
 /*----- Static function implementations ------------------------------*/
 
+// Snap envelopes to zero and clear filter state, so the next note starts
+// as it would from a freshly initialised voice.
+static void _set_idle(t_Aleph_MonoSynth *syn) {
+
+    syn->idle = true;
+
+    Aleph_EnvADSR_reset(&syn->amp_env);
+    Aleph_EnvADSR_reset(&syn->filter_env);
+    Aleph_EnvADSR_reset(&syn->pitch_env);
+
+    Aleph_FilterSVF_reset(&syn->filter);
+    Aleph_HPF_reset(&syn->dc_block);
+}
+
+// Render one block of at most ALEPH_MONOSYNTH_BLOCK_SIZE samples. LFOs and
+// the pitch and filter envelopes are sampled once per block, frequency and
+// amp LFO are ramped across it, filter coefficients are only updated when
+// they change. The amp envelope runs at audio rate.
+static void _render_block(t_Aleph_MonoSynth *syn, fract32 *output,
+                          size_t size) {
+
+    fract32 *amp_env = syn->scratch;
+    fract32 *mod_env = amp_env + ALEPH_MONOSYNTH_BLOCK_SIZE;
+    fract32 *wave_b = mod_env + ALEPH_MONOSYNTH_BLOCK_SIZE;
+
+    t_Aleph_Ramp ramp;
+    t_Aleph_Ramp freq_a;
+    t_Aleph_Ramp freq_b;
+
+    fract32 amp_lfo;
+    fract32 filter_lfo;
+    fract32 pitch_lfo;
+
+    fract32 filter_env;
+    fract32 pitch_env;
+
+    fract32 freq;
+    fract32 freq_offset;
+    fract32 cutoff;
+    fract32 res;
+    fract32 out;
+
+    int i;
+
+    // Calculate LFOs at control rate.
+    pitch_lfo = mult_fr1x32x32(Aleph_Oscillator_next_control(&syn->pitch_lfo,
+                                                             size),
+                               syn->pitch_lfo_depth);
+
+    amp_lfo = mult_fr1x32x32(Aleph_Oscillator_next_control(&syn->amp_lfo, size),
+                             syn->amp_lfo_depth);
+
+    filter_lfo = mult_fr1x32x32(
+        Aleph_Oscillator_next_control(&syn->filter_lfo, size),
+        syn->filter_lfo_depth);
+
+    // Pitch and filter envelopes share a buffer, only the last value is used.
+    Aleph_EnvADSR_next_block(&syn->pitch_env, mod_env, size);
+    pitch_env = mult_fr1x32x32(mod_env[size - 1], syn->pitch_env_depth);
+
+    Aleph_EnvADSR_next_block(&syn->filter_env, mod_env, size);
+    filter_env = mult_fr1x32x32(mod_env[size - 1], syn->filter_env_depth);
+
+    Aleph_EnvADSR_next_block(&syn->amp_env, amp_env, size);
+
+    // Get slewed frequency, apply pitch envelope and LFO.
+    Aleph_SmootherBank_next_ramp(&syn->smoothers,
+                                 ALEPH_MONOSYNTH_SMOOTHER_FREQ, &ramp, size);
+
+    freq = add_fr1x32(pitch_env, Aleph_SmootherBank_get(
+                                     &syn->smoothers,
+                                     ALEPH_MONOSYNTH_SMOOTHER_FREQ));
+
+    freq = add_fr1x32(freq, mult_fr1x32x32(freq, pitch_lfo));
+
+    // Get slewed frequency offset.
+    freq_offset = Aleph_SmootherBank_get(&syn->smoothers,
+                                         ALEPH_MONOSYNTH_SMOOTHER_FREQ_OFFSET);
+
+    // Ramp oscillator frequencies from the end of the last block.
+    Aleph_Ramp_init(&freq_a, syn->block_freq, freq, size);
+    Aleph_Ramp_init(&freq_b, fix16_mul_fract(syn->block_freq, freq_offset),
+                    fix16_mul_fract(freq, freq_offset), size);
+
+    syn->block_freq = freq;
+
+    // Generate waveforms.
+    Aleph_WaveformDual_next_block_ramp_split(&syn->waveform, &freq_a, &freq_b,
+                                             wave_b, output, size);
+
+    // Apply amp envelope and LFO.
+    Aleph_Ramp_init(&ramp, syn->block_amp_lfo, amp_lfo, size);
+    syn->block_amp_lfo = amp_lfo;
+
+    amp_lfo = ramp.start;
+
+    for (i = 0; i < size; i++) {
+
+        amp_lfo = add_fr1x32(amp_lfo, ramp.inc);
+
+        // Shift right to prevent clipping.
+        out = shr_fr1x32(output[i], 1);
+
+        out = mult_fr1x32x32(out,
+                             mult_fr1x32x32(amp_env[i], syn->amp_env_depth));
+
+        output[i] = add_fr1x32(out, mult_fr1x32x32(out, amp_lfo));
+    }
+
+    // Get slewed cutoff, apply filter envelope and LFO.
+    Aleph_SmootherBank_next_ramp(&syn->smoothers,
+                                 ALEPH_MONOSYNTH_SMOOTHER_CUTOFF, &ramp, size);
+
+    cutoff = add_fr1x32(filter_env, Aleph_SmootherBank_get(
+                                        &syn->smoothers,
+                                        ALEPH_MONOSYNTH_SMOOTHER_CUTOFF));
+
+    cutoff = add_fr1x32(cutoff, mult_fr1x32x32(cutoff, filter_lfo));
+
+    // Get slewed resonance.
+    Aleph_SmootherBank_next_ramp(&syn->smoothers, ALEPH_MONOSYNTH_SMOOTHER_RES,
+                                 &ramp, size);
+
+    res = Aleph_SmootherBank_get(&syn->smoothers, ALEPH_MONOSYNTH_SMOOTHER_RES);
+
+    // Only recalculate filter coefficients on change.
+    if (cutoff != syn->cutoff) {
+        syn->cutoff = cutoff;
+        Aleph_FilterSVF_set_coeff(&syn->filter, cutoff);
+    }
+
+    if (res != syn->res) {
+        syn->res = res;
+        Aleph_FilterSVF_set_rq(&syn->filter, res);
+    }
+
+    // Apply filter and block DC.
+    switch (syn->filter_type) {
+
+    case ALEPH_FILTERSVF_TYPE_BPF:
+        Aleph_FilterSVF_sc_bpf_next_block(&syn->filter, output, output, size);
+        break;
+
+    case ALEPH_FILTERSVF_TYPE_HPF:
+        Aleph_FilterSVF_sc_hpf_next_block(&syn->filter, output, output, size);
+        break;
+
+    default:
+        // Default to LPF.
+        Aleph_FilterSVF_sc_lpf_next_block(&syn->filter, output, output, size);
+        break;
+    }
+
+    // Released to silence.
+    if (Aleph_EnvADSR_is_idle(&syn->amp_env)) {
+        _set_idle(syn);
+    }
+}
+
+// Jump straight to value, no smoothing.
+static void _set_smoother(t_Aleph_MonoSynth *syn,
+                          e_Aleph_MonoSynth_smoother smoother, fract32 value) {
+
+    Aleph_SmootherBank_set_target(&syn->smoothers, smoother, value);
+    Aleph_SmootherBank_set_output(&syn->smoothers, smoother, value);
+}
+
 /*----- End of file --------------------------------------------------*/
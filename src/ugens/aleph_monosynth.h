@@ -36,8 +36,8 @@ extern "C" {
 #include "aleph_env_adsr.h"
 #include "aleph_filter.h"
 #include "aleph_filter_svf.h"
-#include "aleph_lpf_one_pole.h"
 #include "aleph_oscillator.h"
+#include "aleph_smoother_bank.h"
 #include "aleph_waveform.h"
 
 /*----- Macros -------------------------------------------------------*/
@@ -59,8 +59,20 @@ extern "C" {
 
 #define ALEPH_MONOSYNTH_DEFAULT_PHASE_RESET (true)
 
+// Longest block rendered in one pass, longer blocks are split.
+#define ALEPH_MONOSYNTH_BLOCK_SIZE (32)
+
 /*----- Typedefs -----------------------------------------------------*/
 
+typedef enum {
+    ALEPH_MONOSYNTH_SMOOTHER_AMP,
+    ALEPH_MONOSYNTH_SMOOTHER_FREQ,
+    ALEPH_MONOSYNTH_SMOOTHER_FREQ_OFFSET,
+    ALEPH_MONOSYNTH_SMOOTHER_CUTOFF,
+    ALEPH_MONOSYNTH_SMOOTHER_RES,
+    ALEPH_MONOSYNTH_NUM_SMOOTHERS,
+} e_Aleph_MonoSynth_smoother;
+
 typedef struct {
 
     Mempool mempool;
@@ -92,14 +104,20 @@ typedef struct {
     fract32 filter_lfo_depth;
     fract32 pitch_lfo_depth;
 
-    Aleph_LPFOnePole amp_slew;
-    Aleph_LPFOnePole freq_slew;
-    Aleph_LPFOnePole freq_offset_slew;
-    Aleph_LPFOnePole cutoff_slew;
-    Aleph_LPFOnePole res_slew;
+    Aleph_SmootherBank smoothers;
+
+    // Block render state, modulation at the end of the last block.
+    fract32 *scratch;
+    fract32 block_freq;
+    fract32 block_amp_lfo;
+    fract32 cutoff;
+    fract32 res;
 
     bool phase_reset;
 
+    // Amp envelope has released to silence.
+    bool idle;
+
 } t_Aleph_MonoSynth;
 
 typedef t_Aleph_MonoSynth *Aleph_MonoSynth;
@@ -114,6 +132,8 @@ void Aleph_MonoSynth_init_to_pool(Aleph_MonoSynth *const synth,
 void Aleph_MonoSynth_free(Aleph_MonoSynth *const synth);
 
 fract32 Aleph_MonoSynth_next(Aleph_MonoSynth *const synth);
+void Aleph_MonoSynth_next_block(Aleph_MonoSynth *const synth, fract32 *output,
+                                size_t size);
 
 void Aleph_MonoSynth_set_shape(Aleph_MonoSynth *const synth,
                                e_Aleph_Waveform_shape shape_a);
@@ -181,6 +201,14 @@ void Aleph_MonoSynth_set_pitch_lfo_depth(Aleph_MonoSynth *const synth,
 void Aleph_MonoSynth_set_gate(Aleph_MonoSynth *const synth, bool gate);
 void Aleph_MonoSynth_set_phase_reset(Aleph_MonoSynth *const synth, bool reset);
 
+bool Aleph_MonoSynth_is_idle(Aleph_MonoSynth *const synth);
+
+// Silence immediately, as if the amp envelope had released.
+void Aleph_MonoSynth_reset(Aleph_MonoSynth *const synth);
+
+// Current amp envelope level, before depth.
+fract32 Aleph_MonoSynth_get_level(Aleph_MonoSynth *const synth);
+
 #ifdef __cplusplus
 }
 #endif
@@ -29,9 +29,9 @@
 #include "aleph_env_adsr.h"
 #include "aleph_filter.h"
 #include "aleph_filter_svf.h"
-#include "aleph_lpf_one_pole.h"
 #include "aleph_mempool.h"
 #include "aleph_oscillator.h"
+#include "aleph_smoother_bank.h"
 #include "aleph_waveform.h"
 #include "fract_typedef.h"
 #include "types.h"
@@ -49,6 +49,11 @@
 
 /*----- Static function prototypes -----------------------------------*/
 
+static void _render_block(t_Aleph_MonoVoice *syn, fract32 *output,
+                          size_t size);
+static void _set_smoother(t_Aleph_MonoVoice *syn,
+                          e_Aleph_MonoVoice_smoother smoother, fract32 value);
+
 /*----- Extern function implementations ------------------------------*/
 
 void Aleph_MonoVoice_init(Aleph_MonoVoice *const synth, t_Aleph *const aleph) {
@@ -75,15 +80,21 @@ void Aleph_MonoVoice_init_to_pool(Aleph_MonoVoice *const synth,
 
     Aleph_HPF_init_to_pool(&syn->dc_block, mempool);
 
-    Aleph_LPFOnePole_init_to_pool(&syn->freq_slew, mempool);
-    Aleph_LPFOnePole_set_output(&syn->freq_slew, ALEPH_MONOVOICE_DEFAULT_FREQ);
+    // Block DC in the final write of the filter block kernel.
+    Aleph_FilterSVF_set_dc_block(&syn->filter, &syn->dc_block);
+
+    Aleph_SmootherBank_init_to_pool(&syn->smoothers,
+                                    ALEPH_MONOVOICE_NUM_SMOOTHERS, mempool);
 
-    Aleph_LPFOnePole_init_to_pool(&syn->cutoff_slew, mempool);
-    Aleph_LPFOnePole_set_output(&syn->cutoff_slew,
-                                ALEPH_MONOVOICE_DEFAULT_CUTOFF);
+    syn->scratch = (fract32 *)mpool_calloc(
+        sizeof(fract32) * ALEPH_MONOVOICE_BLOCK_SIZE, mp);
 
-    Aleph_LPFOnePole_init_to_pool(&syn->amp_slew, mempool);
-    Aleph_LPFOnePole_set_output(&syn->amp_slew, ALEPH_MONOVOICE_DEFAULT_AMP);
+    _set_smoother(syn, ALEPH_MONOVOICE_SMOOTHER_FREQ,
+                  ALEPH_MONOVOICE_DEFAULT_FREQ);
+    _set_smoother(syn, ALEPH_MONOVOICE_SMOOTHER_CUTOFF,
+                  ALEPH_MONOVOICE_DEFAULT_CUTOFF);
+    _set_smoother(syn, ALEPH_MONOVOICE_SMOOTHER_AMP,
+                  ALEPH_MONOVOICE_DEFAULT_AMP);
 }
 
 void Aleph_MonoVoice_free(Aleph_MonoVoice *const synth) {
@@ -96,8 +107,9 @@ void Aleph_MonoVoice_free(Aleph_MonoVoice *const synth) {
 
     Aleph_HPF_free(&syn->dc_block);
 
-    Aleph_LPFOnePole_free(&syn->freq_slew);
-    Aleph_LPFOnePole_free(&syn->cutoff_slew);
+    Aleph_SmootherBank_free(&syn->smoothers);
+
+    mpool_free((char *)syn->scratch, syn->mempool);
 
     mpool_free((char *)syn, syn->mempool);
 }
@@ -112,8 +124,12 @@ fract32 Aleph_MonoVoice_next(Aleph_MonoVoice *const synth) {
     fract32 freq;
     fract32 cutoff;
 
+    // Advance parameter smoothers still converging.
+    Aleph_SmootherBank_next(&syn->smoothers);
+
     // Get slewed frequency.
-    freq = Aleph_LPFOnePole_next(&syn->freq_slew);
+    freq = Aleph_SmootherBank_get(&syn->smoothers,
+                                  ALEPH_MONOVOICE_SMOOTHER_FREQ);
 
     /// TODO: Set oscillator type (Dual, Unison, etc...).
 
@@ -129,13 +145,14 @@ fract32 Aleph_MonoVoice_next(Aleph_MonoVoice *const synth) {
     output = shr_fr1x32(output, 1);
 
     // Get slewed amplitude.
-    amp = Aleph_LPFOnePole_next(&syn->amp_slew);
+    amp = Aleph_SmootherBank_get(&syn->smoothers, ALEPH_MONOVOICE_SMOOTHER_AMP);
 
     // Apply amp modulation.
     output = mult_fr1x32x32(output, amp);
 
     // Get slewed cutoff.
-    cutoff = Aleph_LPFOnePole_next(&syn->cutoff_slew);
+    cutoff = Aleph_SmootherBank_get(&syn->smoothers,
+                                    ALEPH_MONOVOICE_SMOOTHER_CUTOFF);
 
     // Set filter cutoff.
     Aleph_FilterSVF_set_coeff(&syn->filter, cutoff);
@@ -172,69 +189,18 @@ void Aleph_MonoVoice_next_block(Aleph_MonoVoice *const synth, fract32 *output,
 
     t_Aleph_MonoVoice *syn = *synth;
 
-    fract32 *amp = (fract32 *)mpool_alloc(size * sizeof(fract32), syn->mempool);
-
-    fract32 *freq =
-        (fract32 *)mpool_alloc(size * sizeof(fract32), syn->mempool);
-
-    fract32 *cutoff =
-        (fract32 *)mpool_alloc(size * sizeof(fract32), syn->mempool);
-
-    // Get slewed frequency.
-    Aleph_LPFOnePole_next_block(&syn->freq_slew, freq, size);
-
-    // Generate waveforms.
-    Aleph_WaveformDual_next_block_smooth(&syn->waveform, freq, output, size);
-
-    // Get slewed amplitude.
-    Aleph_LPFOnePole_next_block(&syn->amp_slew, amp, size);
-
-    // Apply amp modulation.
-    int i;
-    for (i = 0; i < size; i++) {
-
-        // Shift right to prevent clipping.
-        output[i] = mult_fr1x32x32(shr_fr1x32(output[i], 1), amp[i]);
-    }
-
-    // Get slewed cutoff.
-    Aleph_LPFOnePole_next_block(&syn->cutoff_slew, cutoff, size);
-
-    // Apply filter.
-    switch (syn->filter_type) {
+    size_t block;
 
-    case ALEPH_FILTERSVF_TYPE_LPF:
-        Aleph_FilterSVF_sc_os_lpf_next_block_smooth(&syn->filter, cutoff,
-                                                    output, output, size);
-        break;
+    while (size > 0) {
 
-    /// TODO: Block process other filters.
-    case ALEPH_FILTERSVF_TYPE_BPF:
-        Aleph_FilterSVF_sc_os_lpf_next_block_smooth(&syn->filter, cutoff,
-                                                    output, output, size);
-        break;
+        block = size < ALEPH_MONOVOICE_BLOCK_SIZE ? size
+                                                  : ALEPH_MONOVOICE_BLOCK_SIZE;
 
-    case ALEPH_FILTERSVF_TYPE_HPF:
-        Aleph_FilterSVF_sc_os_lpf_next_block_smooth(&syn->filter, cutoff,
-                                                    output, output, size);
-        break;
-
-    default:
-        // Default to LPF.
-        Aleph_FilterSVF_sc_os_lpf_next_block_smooth(&syn->filter, cutoff,
-                                                    output, output, size);
-        break;
-    }
-
-    // Block DC.
-    for (i = 0; i < size; i++) {
+        _render_block(syn, output, block);
 
-        output[i] = Aleph_HPF_dc_block(&syn->dc_block, output[i]);
+        output += block;
+        size -= block;
     }
-
-    mpool_free((char *)amp, syn->mempool);
-    mpool_free((char *)freq, syn->mempool);
-    mpool_free((char *)cutoff, syn->mempool);
 }
 
 void Aleph_MonoVoice_set_shape(Aleph_MonoVoice *const synth,
@@ -249,7 +215,8 @@ void Aleph_MonoVoice_set_amp(Aleph_MonoVoice *const synth, fract32 amp) {
 
     t_Aleph_MonoVoice *syn = *synth;
 
-    Aleph_LPFOnePole_set_target(&syn->amp_slew, amp);
+    Aleph_SmootherBank_set_target(&syn->smoothers, ALEPH_MONOVOICE_SMOOTHER_AMP,
+                                  amp);
 }
 
 void Aleph_MonoVoice_set_phase(Aleph_MonoVoice *const synth, fract32 phase) {
@@ -263,7 +230,8 @@ void Aleph_MonoVoice_set_freq(Aleph_MonoVoice *const synth, fract32 freq) {
 
     t_Aleph_MonoVoice *syn = *synth;
 
-    Aleph_LPFOnePole_set_target(&syn->freq_slew, freq);
+    Aleph_SmootherBank_set_target(&syn->smoothers,
+                                  ALEPH_MONOVOICE_SMOOTHER_FREQ, freq);
 }
 
 void Aleph_MonoVoice_set_freq_offset(Aleph_MonoVoice *const synth,
@@ -286,7 +254,8 @@ void Aleph_MonoVoice_set_cutoff(Aleph_MonoVoice *const synth, fract32 cutoff) {
 
     t_Aleph_MonoVoice *syn = *synth;
 
-    Aleph_LPFOnePole_set_target(&syn->cutoff_slew, cutoff);
+    Aleph_SmootherBank_set_target(&syn->smoothers,
+                                  ALEPH_MONOVOICE_SMOOTHER_CUTOFF, cutoff);
 }
 
 void Aleph_MonoVoice_set_res(Aleph_MonoVoice *const synth, fract32 res) {
@@ -301,7 +270,8 @@ void Aleph_MonoVoice_set_amp_slew(Aleph_MonoVoice *const synth,
 
     t_Aleph_MonoVoice *syn = *synth;
 
-    Aleph_LPFOnePole_set_coeff(&syn->amp_slew, amp_slew);
+    Aleph_SmootherBank_set_coeff(&syn->smoothers, ALEPH_MONOVOICE_SMOOTHER_AMP,
+                                 amp_slew);
 }
 
 void Aleph_MonoVoice_set_freq_slew(Aleph_MonoVoice *const synth,
@@ -309,7 +279,8 @@ void Aleph_MonoVoice_set_freq_slew(Aleph_MonoVoice *const synth,
 
     t_Aleph_MonoVoice *syn = *synth;
 
-    Aleph_LPFOnePole_set_coeff(&syn->freq_slew, freq_slew);
+    Aleph_SmootherBank_set_coeff(&syn->smoothers, ALEPH_MONOVOICE_SMOOTHER_FREQ,
+                                 freq_slew);
 }
 
 void Aleph_MonoVoice_set_cutoff_slew(Aleph_MonoVoice *const synth,
@@ -317,9 +288,88 @@ void Aleph_MonoVoice_set_cutoff_slew(Aleph_MonoVoice *const synth,
 
     t_Aleph_MonoVoice *syn = *synth;
 
-    Aleph_LPFOnePole_set_coeff(&syn->cutoff_slew, cutoff_slew);
+    Aleph_SmootherBank_set_coeff(&syn->smoothers,
+                                 ALEPH_MONOVOICE_SMOOTHER_CUTOFF, cutoff_slew);
 }
 
 /*----- Static function implementations ------------------------------*/
 
+// Render one block of at most ALEPH_MONOVOICE_BLOCK_SIZE samples.
+static void _render_block(t_Aleph_MonoVoice *syn, fract32 *output,
+                          size_t size) {
+
+    t_Aleph_Ramp amp;
+    t_Aleph_Ramp freq;
+    t_Aleph_Ramp freq_b;
+    t_Aleph_Ramp cutoff;
+
+    fract32 freq_end;
+    fract32 gain;
+
+    // Get slewed parameters as linear ramps over the block.
+    Aleph_SmootherBank_next_ramp(&syn->smoothers,
+                                 ALEPH_MONOVOICE_SMOOTHER_FREQ, &freq, size);
+    Aleph_SmootherBank_next_ramp(&syn->smoothers,
+                                 ALEPH_MONOVOICE_SMOOTHER_AMP, &amp, size);
+    Aleph_SmootherBank_next_ramp(&syn->smoothers,
+                                 ALEPH_MONOVOICE_SMOOTHER_CUTOFF, &cutoff,
+                                 size);
+
+    // Oscillator B follows the frequency ramp scaled by the offset.
+    freq_end =
+        Aleph_SmootherBank_get(&syn->smoothers, ALEPH_MONOVOICE_SMOOTHER_FREQ);
+
+    Aleph_Ramp_init(&freq_b, fix16_mul_fract(freq.start, syn->freq_offset),
+                    fix16_mul_fract(freq_end, syn->freq_offset), size);
+
+    // Generate waveforms.
+    Aleph_WaveformDual_next_block_ramp_split(&syn->waveform, &freq, &freq_b,
+                                             syn->scratch, output, size);
+
+    // Apply amp modulation.
+    gain = amp.start;
+
+    int i;
+    for (i = 0; i < size; i++) {
+
+        gain = add_fr1x32(gain, amp.inc);
+
+        // Shift right to prevent clipping.
+        output[i] = mult_fr1x32x32(shr_fr1x32(output[i], 1), gain);
+    }
+
+    // Apply filter and block DC.
+    switch (syn->filter_type) {
+
+    case ALEPH_FILTERSVF_TYPE_LPF:
+        Aleph_FilterSVF_sc_os_lpf_next_block_ramp(&syn->filter, &cutoff,
+                                                  output, output, size);
+        break;
+
+    case ALEPH_FILTERSVF_TYPE_BPF:
+        Aleph_FilterSVF_sc_os_bpf_next_block_ramp(&syn->filter, &cutoff,
+                                                  output, output, size);
+        break;
+
+    case ALEPH_FILTERSVF_TYPE_HPF:
+        Aleph_FilterSVF_sc_os_hpf_next_block_ramp(&syn->filter, &cutoff,
+                                                  output, output, size);
+        break;
+
+    default:
+        // Default to LPF.
+        Aleph_FilterSVF_sc_os_lpf_next_block_ramp(&syn->filter, &cutoff,
+                                                  output, output, size);
+        break;
+    }
+}
+
+// Jump straight to value, no smoothing.
+static void _set_smoother(t_Aleph_MonoVoice *syn,
+                          e_Aleph_MonoVoice_smoother smoother, fract32 value) {
+
+    Aleph_SmootherBank_set_target(&syn->smoothers, smoother, value);
+    Aleph_SmootherBank_set_output(&syn->smoothers, smoother, value);
+}
+
 /*----- End of file --------------------------------------------------*/
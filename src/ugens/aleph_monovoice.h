@@ -35,7 +35,7 @@ extern "C" {
 
 #include "aleph_filter.h"
 #include "aleph_filter_svf.h"
-#include "aleph_lpf_one_pole.h"
+#include "aleph_smoother_bank.h"
 #include "aleph_waveform.h"
 
 /*----- Macros -------------------------------------------------------*/
@@ -48,8 +48,18 @@ extern "C" {
 #define ALEPH_MONOVOICE_DEFAULT_RES (FR32_MAX)
 #define ALEPH_MONOVOICE_DEFAULT_FILTER_TYPE ALEPH_FILTERSVF_TYPE_LPF
 
+// Longest block rendered in one pass, longer blocks are split.
+#define ALEPH_MONOVOICE_BLOCK_SIZE (32)
+
 /*----- Typedefs -----------------------------------------------------*/
 
+typedef enum {
+    ALEPH_MONOVOICE_SMOOTHER_AMP,
+    ALEPH_MONOVOICE_SMOOTHER_FREQ,
+    ALEPH_MONOVOICE_SMOOTHER_CUTOFF,
+    ALEPH_MONOVOICE_NUM_SMOOTHERS,
+} e_Aleph_MonoVoice_smoother;
+
 typedef struct {
 
     Mempool mempool;
@@ -60,12 +70,13 @@ typedef struct {
     Aleph_FilterSVF filter;
     e_Aleph_FilterSVF_type filter_type;
 
-    Aleph_LPFOnePole amp_slew;
-    Aleph_LPFOnePole freq_slew;
-    Aleph_LPFOnePole cutoff_slew;
+    Aleph_SmootherBank smoothers;
 
     Aleph_HPF dc_block;
 
+    // Oscillator B buffer for block rendering.
+    fract32 *scratch;
+
 } t_Aleph_MonoVoice;
 
 typedef t_Aleph_MonoVoice *Aleph_MonoVoice;
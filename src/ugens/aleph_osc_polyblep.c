@@ -117,6 +117,34 @@ void square_polyblep_block_smooth(fract32 *phase, fract32 *freq,
     }
 }
 
+void square_polyblep_block_ramp(fract32 *phase, t_Aleph_Ramp *freq,
+                                fract32 *output, size_t size) {
+
+    fix16 square_raw;
+    fix16 square_pb;
+
+    fract32 f = freq->start;
+
+    int i;
+    for (i = 0; i < size; i++) {
+
+        f = add_fr1x32(f, freq->inc);
+
+        square_raw = 0xFFFF;
+
+        if (phase[i] < 0) {
+
+            square_raw *= -1;
+        }
+
+        square_pb = add_fr1x32(square_raw, _polyblep(phase[i] + FR32_MAX, f));
+
+        square_pb = sub_fr1x32(square_pb, _polyblep(phase[i], f));
+
+        output[i] = (fract16)shr_fr1x32(square_pb, 1);
+    }
+}
+
 fract16 saw_polyblep(fract32 p, fract32 dp) {
 
     return shr_fr1x32(sub_fr1x32(shr_fr1x32(p, 15), _polyblep(p, dp)), 1);
@@ -145,6 +173,21 @@ void saw_polyblep_block_smooth(fract32 *phase, fract32 *freq, fract32 *output,
     }
 }
 
+void saw_polyblep_block_ramp(fract32 *phase, t_Aleph_Ramp *freq,
+                             fract32 *output, size_t size) {
+
+    fract32 f = freq->start;
+
+    int i;
+    for (i = 0; i < size; i++) {
+
+        f = add_fr1x32(f, freq->inc);
+
+        output[i] = shr_fr1x32(
+            sub_fr1x32(shr_fr1x32(phase[i], 15), _polyblep(phase[i], f)), 1);
+    }
+}
+
 fract16 sine_polyblep(fract32 phase) {
 
     fract16 phase16;
@@ -35,6 +35,8 @@ extern "C" {
 
 #include "aleph.h"
 
+#include "aleph_interpolate.h"
+
 /*----- Macros -------------------------------------------------------*/
 
 /*----- Typedefs -----------------------------------------------------*/
@@ -54,12 +56,18 @@ void saw_polyblep_block(fract32 *phase, fract32 freq, fract32 *output,
 void saw_polyblep_block_smooth(fract32 *phase, fract32 *freq, fract32 *output,
                                size_t size);
 
+void saw_polyblep_block_ramp(fract32 *phase, t_Aleph_Ramp *freq,
+                             fract32 *output, size_t size);
+
 void square_polyblep_block(fract32 *phase, fract32 freq, fract32 *output,
                            size_t size);
 
 void square_polyblep_block_smooth(fract32 *phase, fract32 *freq,
                                   fract32 *output, size_t size);
 
+void square_polyblep_block_ramp(fract32 *phase, t_Aleph_Ramp *freq,
+                                fract32 *output, size_t size);
+
 void sine_polyblep_block(fract32 *phase, fract32 *output, size_t size);
 
 void triangle_polyblep_block(fract32 *phase, fract32 *output, size_t size);
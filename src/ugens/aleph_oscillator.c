@@ -42,6 +42,8 @@
 
 /*----- Static function prototypes -----------------------------------*/
 
+static fract32 _calc_shape(t_Aleph_Oscillator *osc);
+
 /*----- Extern function implementations ------------------------------*/
 
 void Aleph_Oscillator_init(Aleph_Oscillator *const oscillator,
@@ -78,36 +80,22 @@ fract32 Aleph_Oscillator_next(Aleph_Oscillator *const oscillator) {
 
     t_Aleph_Oscillator *osc = *oscillator;
 
-    fract32 next;
-
     Aleph_Phasor_next(&osc->phasor);
 
-    switch (osc->shape) {
-
-    case ALEPH_OSCILLATOR_SHAPE_SINE:
-        next = osc_sin(osc->phasor->phase);
-        break;
-
-    case ALEPH_OSCILLATOR_SHAPE_TRIANGLE:
-        next = osc_triangle(osc->phasor->phase);
-        break;
+    return _calc_shape(osc);
+}
 
-    case ALEPH_OSCILLATOR_SHAPE_SAW:
+fract32 Aleph_Oscillator_next_control(Aleph_Oscillator *const oscillator,
+                                      size_t size) {
 
-        /// TODO: Is this bipolar?
-        next = osc->phasor->phase;
-        break;
+    t_Aleph_Oscillator *osc = *oscillator;
 
-    case ALEPH_OSCILLATOR_SHAPE_SQUARE:
-        next = osc_square(osc->phasor->phase);
-        break;
+    t_Aleph_Phasor *ph = osc->phasor;
 
-    default:
-        next = 0;
-        break;
-    }
+    // Skip ahead a whole block, phase wraps as it would sample by sample.
+    ph->phase = (int32_t)((uint32_t)ph->phase + (uint32_t)ph->freq * size);
 
-    return next;
+    return _calc_shape(osc);
 }
 
 fract16 Aleph_Oscillator_16_next(Aleph_Oscillator *const oscillator) {
@@ -246,4 +234,36 @@ fract16 osc_saw16(fract32 phase) { return trunc_fr1x32(phase); }
 
 /*----- Static function implementations ------------------------------*/
 
+static fract32 _calc_shape(t_Aleph_Oscillator *osc) {
+
+    fract32 next;
+
+    switch (osc->shape) {
+
+    case ALEPH_OSCILLATOR_SHAPE_SINE:
+        next = osc_sin(osc->phasor->phase);
+        break;
+
+    case ALEPH_OSCILLATOR_SHAPE_TRIANGLE:
+        next = osc_triangle(osc->phasor->phase);
+        break;
+
+    case ALEPH_OSCILLATOR_SHAPE_SAW:
+
+        /// TODO: Is this bipolar?
+        next = osc->phasor->phase;
+        break;
+
+    case ALEPH_OSCILLATOR_SHAPE_SQUARE:
+        next = osc_square(osc->phasor->phase);
+        break;
+
+    default:
+        next = 0;
+        break;
+    }
+
+    return next;
+}
+
 /*----- End of file --------------------------------------------------*/
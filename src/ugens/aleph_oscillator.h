@@ -81,6 +81,10 @@ void Aleph_Oscillator_set_shape(Aleph_Oscillator *const oscillator,
                                 e_Aleph_Oscillator_shape shape);
 
 fract32 Aleph_Oscillator_next(Aleph_Oscillator *const oscillator);
+
+// Advance `size` samples and return the last, for control rate modulation.
+fract32 Aleph_Oscillator_next_control(Aleph_Oscillator *const oscillator,
+                                      size_t size);
 fract16 Aleph_Oscillator_16_next(Aleph_Oscillator *const oscillator);
 
 fract32 osc_sin(fract32 phase);
@@ -0,0 +1,286 @@
+/*----------------------------------------------------------------------
+
+                     This file is part of Aleph DSP
+
+                https://github.com/bangcorrupt/aleph-dsp
+
+         Aleph DSP is based on monome/aleph and spiricom/LEAF.
+
+                              MIT License
+
+            Aleph dedicated to the public domain by monome.
+
+                LEAF Copyright Jeff Snyder et. al. 2020
+
+                       Copyright bangcorrupt 2024
+
+----------------------------------------------------------------------*/
+
+/**
+ * @file    aleph_oversampler.c
+ *
+ * @brief   Polyphase half-band oversampler.
+ *
+ *          Half-band FIR has every other coefficient zero and the centre
+ *          tap at 0.5, so each polyphase branch is either a pure delay or
+ *          a symmetric filter costing one multiply per coefficient pair.
+ */
+
+/*----- Includes -----------------------------------------------------*/
+
+#include "aleph.h"
+
+#include "aleph_utils.h"
+
+#include "aleph_oversampler.h"
+
+/*----- Macros -------------------------------------------------------*/
+
+// Samples per chunk through the 4x intermediate rate.
+#define OVERSAMPLER_CHUNK_SIZE (16)
+
+/*----- Typedefs -----------------------------------------------------*/
+
+/*----- Static variable definitions ----------------------------------*/
+
+// Kaiser windowed sinc, beta 8, 31 taps.
+// Stopband -80 dB from 0.33 of the oversampled rate.
+static const fract32 s_halfband_coeffs_8[8] = {
+    673642832, -199558179, 94055049, -46077736,
+    20977483,  -8215096,   2484028,  -437469,
+};
+
+// Kaiser windowed sinc, beta 6, 15 taps, for the second 4x stage.
+// Stopband -63 dB from 0.375 of the oversampled rate.
+static const fract32 s_halfband_coeffs_4[4] = {
+    654648955,
+    -153009553,
+    41794273,
+    -6562763,
+};
+
+/*----- Extern variable definitions ----------------------------------*/
+
+/*----- Static function prototypes -----------------------------------*/
+
+static void _halfband_init(t_Aleph_HalfBand *hb, const fract32 *coeffs,
+                           uint8_t num_taps);
+static void _halfband_reset(t_Aleph_HalfBand *hb);
+static inline fract32 *_halfband_push(t_Aleph_HalfBand *hb, fract32 *buffer,
+                                      fract32 in);
+static inline int64_t _halfband_mac(t_Aleph_HalfBand *hb, fract32 *window);
+static void _halfband_upsample(t_Aleph_HalfBand *hb, fract32 *input,
+                               fract32 *output, size_t size);
+static void _halfband_downsample(t_Aleph_HalfBand *hb, fract32 *input,
+                                 fract32 *output, size_t size);
+
+/*----- Extern function implementations ------------------------------*/
+
+void Aleph_Oversampler_init(Aleph_Oversampler *const oversampler,
+                            e_Aleph_Oversampler_factor factor,
+                            t_Aleph *const aleph) {
+
+    Aleph_Oversampler_init_to_pool(oversampler, factor, &aleph->mempool);
+}
+
+void Aleph_Oversampler_init_to_pool(Aleph_Oversampler *const oversampler,
+                                    e_Aleph_Oversampler_factor factor,
+                                    Mempool *const mempool) {
+
+    t_Mempool *mp = *mempool;
+
+    t_Aleph_Oversampler *os = *oversampler =
+        (t_Aleph_Oversampler *)mpool_alloc(sizeof(t_Aleph_Oversampler), mp);
+
+    os->mempool = mp;
+
+    os->factor = factor;
+
+    _halfband_init(&os->up[0], s_halfband_coeffs_8, 8);
+    _halfband_init(&os->down[0], s_halfband_coeffs_8, 8);
+
+    // Images of the first stage are already rejected, so the second
+    // stage has a wider transition band and needs fewer taps.
+    _halfband_init(&os->up[1], s_halfband_coeffs_4, 4);
+    _halfband_init(&os->down[1], s_halfband_coeffs_4, 4);
+}
+
+void Aleph_Oversampler_free(Aleph_Oversampler *const oversampler) {
+
+    t_Aleph_Oversampler *os = *oversampler;
+
+    mpool_free((char *)os, os->mempool);
+}
+
+void Aleph_Oversampler_reset(Aleph_Oversampler *const oversampler) {
+
+    t_Aleph_Oversampler *os = *oversampler;
+
+    _halfband_reset(&os->up[0]);
+    _halfband_reset(&os->up[1]);
+    _halfband_reset(&os->down[0]);
+    _halfband_reset(&os->down[1]);
+}
+
+void Aleph_Oversampler_upsample_block(Aleph_Oversampler *const oversampler,
+                                      fract32 *input, fract32 *output,
+                                      size_t size) {
+
+    t_Aleph_Oversampler *os = *oversampler;
+
+    fract32 buffer[OVERSAMPLER_CHUNK_SIZE * 2];
+    size_t chunk;
+
+    if (os->factor == ALEPH_OVERSAMPLER_FACTOR_2) {
+
+        _halfband_upsample(&os->up[0], input, output, size);
+
+    } else {
+
+        while (size > 0) {
+
+            chunk = size < OVERSAMPLER_CHUNK_SIZE ? size
+                                                  : OVERSAMPLER_CHUNK_SIZE;
+
+            _halfband_upsample(&os->up[0], input, buffer, chunk);
+            _halfband_upsample(&os->up[1], buffer, output, chunk * 2);
+
+            input += chunk;
+            output += chunk * 4;
+            size -= chunk;
+        }
+    }
+}
+
+void Aleph_Oversampler_downsample_block(Aleph_Oversampler *const oversampler,
+                                        fract32 *input, fract32 *output,
+                                        size_t size) {
+
+    t_Aleph_Oversampler *os = *oversampler;
+
+    fract32 buffer[OVERSAMPLER_CHUNK_SIZE * 2];
+    size_t chunk;
+
+    if (os->factor == ALEPH_OVERSAMPLER_FACTOR_2) {
+
+        _halfband_downsample(&os->down[0], input, output, size);
+
+    } else {
+
+        while (size > 0) {
+
+            chunk = size < OVERSAMPLER_CHUNK_SIZE ? size
+                                                  : OVERSAMPLER_CHUNK_SIZE;
+
+            _halfband_downsample(&os->down[1], input, buffer, chunk * 2);
+            _halfband_downsample(&os->down[0], buffer, output, chunk);
+
+            input += chunk * 4;
+            output += chunk;
+            size -= chunk;
+        }
+    }
+}
+
+/*----- Static function implementations ------------------------------*/
+
+static void _halfband_init(t_Aleph_HalfBand *hb, const fract32 *coeffs,
+                           uint8_t num_taps) {
+
+    hb->coeffs = coeffs;
+    hb->num_taps = num_taps;
+
+    _halfband_reset(hb);
+}
+
+static void _halfband_reset(t_Aleph_HalfBand *hb) {
+
+    int i;
+    for (i = 0; i < ALEPH_HALFBAND_BUFFER_SIZE; i++) {
+        hb->even[i] = 0;
+        hb->odd[i] = 0;
+    }
+
+    hb->index = 0;
+}
+
+// Write to both halves of doubled delay line, so the last 2 * num_taps
+// samples are contiguous, oldest first.
+// Caller advances hb->index.
+static inline fract32 *_halfband_push(t_Aleph_HalfBand *hb, fract32 *buffer,
+                                      fract32 in) {
+
+    uint8_t length = hb->num_taps * 2;
+
+    buffer[hb->index] = in;
+    buffer[hb->index + length] = in;
+
+    return &buffer[hb->index + 1];
+}
+
+// Sum of symmetric pairs, halved to avoid overflow, scaled by 2^-62.
+static inline int64_t _halfband_mac(t_Aleph_HalfBand *hb, fract32 *window) {
+
+    const fract32 *coeffs = hb->coeffs;
+    uint8_t taps = hb->num_taps;
+    int64_t acc = 0;
+
+    int j;
+    for (j = 0; j < taps; j++) {
+        acc += (int64_t)((window[taps + j] >> 1) +
+                         (window[taps - 1 - j] >> 1)) *
+               coeffs[j];
+    }
+
+    return acc;
+}
+
+// Zero stuffing with gain of 2, the centre tap branch is a pure delay.
+static void _halfband_upsample(t_Aleph_HalfBand *hb, fract32 *input,
+                               fract32 *output, size_t size) {
+
+    uint8_t length = hb->num_taps * 2;
+    fract32 *window;
+
+    int i;
+    for (i = 0; i < size; i++) {
+
+        window = _halfband_push(hb, hb->even, input[i]);
+
+        if (++hb->index >= length) {
+            hb->index = 0;
+        }
+
+        output[2 * i] = sat_fr32(_halfband_mac(hb, window) >> 29);
+        output[2 * i + 1] = window[hb->num_taps];
+    }
+}
+
+// Even input phase through the filter branch, odd phase through the
+// centre tap.
+static void _halfband_downsample(t_Aleph_HalfBand *hb, fract32 *input,
+                                 fract32 *output, size_t size) {
+
+    uint8_t length = hb->num_taps * 2;
+    fract32 *window;
+    fract32 *centre;
+    int64_t acc;
+
+    int i;
+    for (i = 0; i < size; i++) {
+
+        window = _halfband_push(hb, hb->even, input[2 * i]);
+        centre = _halfband_push(hb, hb->odd, input[2 * i + 1]);
+
+        if (++hb->index >= length) {
+            hb->index = 0;
+        }
+
+        acc = _halfband_mac(hb, window);
+        acc += (int64_t)centre[hb->num_taps - 1] << 29;
+
+        output[i] = sat_fr32(acc >> 30);
+    }
+}
+
+/*----- End of file --------------------------------------------------*/
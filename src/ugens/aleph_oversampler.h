@@ -0,0 +1,104 @@
+/*----------------------------------------------------------------------
+
+                     This file is part of Aleph DSP
+
+                https://github.com/bangcorrupt/aleph-dsp
+
+         Aleph DSP is based on monome/aleph and spiricom/LEAF.
+
+                              MIT License
+
+            Aleph dedicated to the public domain by monome.
+
+                LEAF Copyright Jeff Snyder et. al. 2020
+
+                       Copyright bangcorrupt 2024
+
+----------------------------------------------------------------------*/
+
+/**
+ * @file    aleph_oversampler.h
+ *
+ * @brief   Public API for polyphase half-band oversampler.
+ *
+ *          Wrap a nonlinear stage as:
+ *
+ *              Aleph_Oversampler_upsample_block(&os, in, buf, size);
+ *              process(buf, size * factor);
+ *              Aleph_Oversampler_downsample_block(&os, buf, out, size);
+ */
+
+#ifndef ALEPH_OVERSAMPLER_H
+#define ALEPH_OVERSAMPLER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*----- Includes -----------------------------------------------------*/
+
+#include "aleph.h"
+
+/*----- Macros -------------------------------------------------------*/
+
+// Maximum number of non-zero coefficients in each half of the filter.
+#define ALEPH_HALFBAND_MAX_TAPS (8)
+
+// Doubled delay line, window is 2 * taps samples.
+#define ALEPH_HALFBAND_BUFFER_SIZE (4 * ALEPH_HALFBAND_MAX_TAPS)
+
+/*----- Typedefs -----------------------------------------------------*/
+
+typedef enum {
+    ALEPH_OVERSAMPLER_FACTOR_2 = 2,
+    ALEPH_OVERSAMPLER_FACTOR_4 = 4,
+} e_Aleph_Oversampler_factor;
+
+typedef struct {
+    const fract32 *coeffs;
+    uint8_t num_taps;
+    uint8_t index;
+    fract32 even[ALEPH_HALFBAND_BUFFER_SIZE];
+    fract32 odd[ALEPH_HALFBAND_BUFFER_SIZE];
+} t_Aleph_HalfBand;
+
+typedef struct {
+    Mempool mempool;
+    e_Aleph_Oversampler_factor factor;
+    t_Aleph_HalfBand up[2];
+    t_Aleph_HalfBand down[2];
+} t_Aleph_Oversampler;
+
+typedef t_Aleph_Oversampler *Aleph_Oversampler;
+
+/*----- Extern variable declarations ---------------------------------*/
+
+/*----- Extern function prototypes -----------------------------------*/
+
+void Aleph_Oversampler_init(Aleph_Oversampler *const oversampler,
+                            e_Aleph_Oversampler_factor factor,
+                            t_Aleph *const aleph);
+void Aleph_Oversampler_init_to_pool(Aleph_Oversampler *const oversampler,
+                                    e_Aleph_Oversampler_factor factor,
+                                    Mempool *const mempool);
+void Aleph_Oversampler_free(Aleph_Oversampler *const oversampler);
+
+void Aleph_Oversampler_reset(Aleph_Oversampler *const oversampler);
+
+// Output holds size * factor samples, must not overlap input.
+void Aleph_Oversampler_upsample_block(Aleph_Oversampler *const oversampler,
+                                      fract32 *input, fract32 *output,
+                                      size_t size);
+
+// Input holds size * factor samples.
+// Allows using same buffer for input and output.
+void Aleph_Oversampler_downsample_block(Aleph_Oversampler *const oversampler,
+                                        fract32 *input, fract32 *output,
+                                        size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+/*----- End of file --------------------------------------------------*/
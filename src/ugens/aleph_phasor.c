@@ -105,6 +105,28 @@ void Aleph_Phasor_next_block_smooth(Aleph_Phasor *const phasor, fract32 *freq,
     }
 }
 
+void Aleph_Phasor_next_block_ramp(Aleph_Phasor *const phasor,
+                                  t_Aleph_Ramp *freq, fract32 *output,
+                                  size_t size) {
+
+    t_Aleph_Phasor *ph = *phasor;
+
+    fract32 f = freq->start;
+    fract32 inc = freq->inc;
+
+    int i;
+    for (i = 0; i < size; i++) {
+
+        f = add_fr1x32(f, inc);
+
+        ph->phase += f;
+
+        output[i] = ph->phase;
+    }
+
+    ph->freq = f;
+}
+
 void Aleph_Phasor_set_freq(Aleph_Phasor *const phasor, fract32 freq) {
 
     t_Aleph_Phasor *ph = *phasor;
@@ -33,6 +33,8 @@ extern "C" {
 
 #include "aleph.h"
 
+#include "aleph_interpolate.h"
+
 /*----- Macros -------------------------------------------------------*/
 
 #define ALEPH_PHASOR_DEFAULT_PHASE (0)
@@ -100,6 +102,10 @@ void Aleph_Phasor_next_block(Aleph_Phasor *const phasor, fract32 *output,
 void Aleph_Phasor_next_block_smooth(Aleph_Phasor *const phasor, fract32 *freq,
                                     fract32 *output, size_t size);
 
+void Aleph_Phasor_next_block_ramp(Aleph_Phasor *const phasor,
+                                  t_Aleph_Ramp *freq, fract32 *output,
+                                  size_t size);
+
 #ifdef __cplusplus
 }
 #endif
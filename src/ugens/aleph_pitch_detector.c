@@ -22,6 +22,8 @@
  * @file    aleph_pitch_detector.c
  *
  * @brief   Pitch detection.
+ *
+ *          YIN: de Cheveigne and Kawahara, 2002.
  */
 
 /*----- Includes -----------------------------------------------------*/
@@ -30,11 +32,15 @@
 
 #include "aleph_filter.h"
 #include "aleph_oscillator.h"
+#include "aleph_oversampler.h"
 
 #include "aleph_pitch_detector.h"
 
 /*----- Macros -------------------------------------------------------*/
 
+// Input samples per call to the decimator.
+#define YIN_CHUNK_SIZE (64)
+
 /*----- Typedefs -----------------------------------------------------*/
 
 /*----- Static variable definitions ----------------------------------*/
@@ -43,6 +49,15 @@
 
 /*----- Static function prototypes -----------------------------------*/
 
+static void _set_period(t_Aleph_PitchDetector *pd, fract32 period);
+static inline void _track(t_Aleph_PitchDetector *pd, fract32 in);
+static inline fract32 _osc_shape(e_Aleph_Oscillator_shape shape,
+                                 fract32 phase);
+
+static void _yin_push(t_Aleph_PitchDetectorYIN *pd, fract16 in);
+static void _yin_lag(t_Aleph_PitchDetectorYIN *pd);
+static void _yin_publish(t_Aleph_PitchDetectorYIN *pd);
+
 /*----- Extern function implementations ------------------------------*/
 
 void Aleph_PitchDetector_init(Aleph_PitchDetector *const pitch_detect,
@@ -59,16 +74,30 @@ void Aleph_PitchDetector_init_to_pool(Aleph_PitchDetector *const pitch_detect,
     t_Aleph_PitchDetector *pd = *pitch_detect =
         (t_Aleph_PitchDetector *)mpool_alloc(sizeof(t_Aleph_PitchDetector), mp);
 
-    pd->current_period = 48 << ALEPH_PITCH_DETECTOR_RADIX_TOTAL;
+    pd->mempool = mp;
+
     pd->period = 48 << ALEPH_PITCH_DETECTOR_RADIX_TOTAL;
     pd->last_in = 1;
     pd->phase = 0;
     pd->nsamples = 100;
     pd->nframes = 100;
     pd->pitch_offset = FR32_MAX >> 2;
+    pd->shape = ALEPH_OSCILLATOR_SHAPE_SINE;
 
     Aleph_HPF_init_to_pool(&(pd->dcblocker), mempool);
     Aleph_LPF_init_to_pool(&(pd->adaptive_filter), mempool);
+
+    _set_period(pd, 48 << ALEPH_PITCH_DETECTOR_RADIX_TOTAL);
+}
+
+void Aleph_PitchDetector_free(Aleph_PitchDetector *const pitch_detect) {
+
+    t_Aleph_PitchDetector *pd = *pitch_detect;
+
+    Aleph_LPF_free(&(pd->adaptive_filter));
+    Aleph_HPF_free(&(pd->dcblocker));
+
+    mpool_free((char *)pd, pd->mempool);
 }
 
 // This guy returns the current measured wave period (in subsamples)
@@ -77,53 +106,384 @@ fract32 Aleph_PitchDetector_track_next(Aleph_PitchDetector *const pitch_detect,
 
     t_Aleph_PitchDetector *pd = *pitch_detect;
 
-    fract32 centreFreq = FR32_MAX / pd->current_period;
+    _track(pd, in);
+
+    return (shl_fr1x32(pd->current_period,
+                       ALEPH_PITCH_DETECTOR_RADIX_EXTERNAL -
+                           ALEPH_PITCH_DETECTOR_RADIX_INTERNAL));
+}
+
+fract32 Aleph_PitchDetector_osc_next(Aleph_PitchDetector *const pitch_detect) {
+
+    t_Aleph_PitchDetector *pd = *pitch_detect;
+
+    // Debug uncomment the line below to force 1k tone
+    /* _set_period(pd, 48 << ALEPH_PITCH_DETECTOR_RADIX_INTERNAL); */
+
+    pd->phase += pd->osc_inc;
+
+    return _osc_shape(pd->shape, pd->phase);
+}
+
+fract32
+Aleph_PitchDetector_track_next_block(Aleph_PitchDetector *const pitch_detect,
+                                     fract32 *input, size_t size) {
+
+    t_Aleph_PitchDetector *pd = *pitch_detect;
+
+    int i;
+    for (i = 0; i < size; i++) {
+        _track(pd, input[i]);
+    }
+
+    return (shl_fr1x32(pd->current_period,
+                       ALEPH_PITCH_DETECTOR_RADIX_EXTERNAL -
+                           ALEPH_PITCH_DETECTOR_RADIX_INTERNAL));
+}
+
+void Aleph_PitchDetector_osc_next_block(Aleph_PitchDetector *const pitch_detect,
+                                        fract32 *output, size_t size) {
+
+    t_Aleph_PitchDetector *pd = *pitch_detect;
+
+    fract32 phase = pd->phase;
+    fract32 inc = pd->osc_inc;
+
+    int i;
+
+    switch (pd->shape) {
+
+    case ALEPH_OSCILLATOR_SHAPE_TRIANGLE:
+        for (i = 0; i < size; i++) {
+            phase += inc;
+            output[i] = osc_triangle(phase);
+        }
+        break;
+
+    case ALEPH_OSCILLATOR_SHAPE_SAW:
+        for (i = 0; i < size; i++) {
+            phase += inc;
+            output[i] = phase;
+        }
+        break;
+
+    case ALEPH_OSCILLATOR_SHAPE_SQUARE:
+        for (i = 0; i < size; i++) {
+            phase += inc;
+            output[i] = osc_square(phase);
+        }
+        break;
+
+    default:
+        for (i = 0; i < size; i++) {
+            phase += inc;
+            output[i] = osc_sin(phase);
+        }
+        break;
+    }
+
+    pd->phase = phase;
+}
+
+void Aleph_PitchDetector_set_shape(Aleph_PitchDetector *const pitch_detect,
+                                   e_Aleph_Oscillator_shape shape) {
+
+    t_Aleph_PitchDetector *pd = *pitch_detect;
+
+    pd->shape = shape;
+}
+
+void Aleph_PitchDetector_set_pitch_offset(
+    Aleph_PitchDetector *const pitch_detect, fract32 pitch_offset) {
+
+    t_Aleph_PitchDetector *pd = *pitch_detect;
+
+    pd->pitch_offset = pitch_offset;
+
+    _set_period(pd, pd->current_period);
+}
+
+/// TODO: Convenience function to track and return oscillator in one call.
+
+void Aleph_PitchDetectorYIN_init(Aleph_PitchDetectorYIN *const pitch_detect,
+                                 t_Aleph *const aleph) {
+
+    Aleph_PitchDetectorYIN_init_to_pool(pitch_detect, &aleph->mempool);
+}
+
+void Aleph_PitchDetectorYIN_init_to_pool(
+    Aleph_PitchDetectorYIN *const pitch_detect, Mempool *const mempool) {
+
+    t_Mempool *mp = *mempool;
+
+    t_Aleph_PitchDetectorYIN *pd = *pitch_detect =
+        (t_Aleph_PitchDetectorYIN *)mpool_alloc(
+            sizeof(t_Aleph_PitchDetectorYIN), mp);
+
+    pd->mempool = mp;
+
+    pd->threshold = ALEPH_YIN_DEFAULT_THRESHOLD;
+
+    Aleph_Oversampler_init_to_pool(&pd->decimator, ALEPH_OVERSAMPLER_FACTOR_4,
+                                   mempool);
+
+    Aleph_PitchDetectorYIN_reset(pitch_detect);
+}
+
+void Aleph_PitchDetectorYIN_free(Aleph_PitchDetectorYIN *const pitch_detect) {
+
+    t_Aleph_PitchDetectorYIN *pd = *pitch_detect;
+
+    Aleph_Oversampler_free(&pd->decimator);
+
+    mpool_free((char *)pd, pd->mempool);
+}
+
+void Aleph_PitchDetectorYIN_reset(Aleph_PitchDetectorYIN *const pitch_detect) {
+
+    t_Aleph_PitchDetectorYIN *pd = *pitch_detect;
+
+    Aleph_Oversampler_reset(&pd->decimator);
+
+    pd->count = 0;
+    pd->lag = 0;
+    pd->analysing = false;
+    pd->running_sum = 0;
+
+    // 100 Hz at 48 kHz until the first estimate.
+    pd->period = 480 << 16;
+    pd->confidence = 0;
+}
 
-    in = Aleph_LPF_next_dynamic_precise(
-        &(pd->adaptive_filter), in,
-        shl_fr1x32(centreFreq, ALEPH_PITCH_DETECTOR_RADIX_INTERNAL + 3));
+void Aleph_PitchDetectorYIN_next_block(
+    Aleph_PitchDetectorYIN *const pitch_detect, fract32 *input, size_t size) {
 
-    in = Aleph_HPF_next_dynamic_precise(
-        &(pd->dcblocker), in,
-        shl_fr1x32(centreFreq, ALEPH_PITCH_DETECTOR_RADIX_INTERNAL - 3));
+    t_Aleph_PitchDetectorYIN *pd = *pitch_detect;
+
+    fract32 decimated[YIN_CHUNK_SIZE / ALEPH_YIN_DECIMATION];
+    size_t chunk;
+
+    int i;
+    while (size > 0) {
+
+        chunk = size < YIN_CHUNK_SIZE ? size : YIN_CHUNK_SIZE;
+        chunk /= ALEPH_YIN_DECIMATION;
+
+        if (chunk == 0) {
+            break;
+        }
+
+        Aleph_Oversampler_downsample_block(&pd->decimator, input, decimated,
+                                           chunk);
+
+        // Each decimated sample carries a fixed share of the analysis.
+        for (i = 0; i < chunk; i++) {
+            _yin_push(pd, trunc_fr1x32(decimated[i]));
+        }
+
+        input += chunk * ALEPH_YIN_DECIMATION;
+        size -= chunk * ALEPH_YIN_DECIMATION;
+    }
+}
+
+fix16 Aleph_PitchDetectorYIN_get_period(
+    Aleph_PitchDetectorYIN *const pitch_detect) {
+
+    t_Aleph_PitchDetectorYIN *pd = *pitch_detect;
+
+    return pd->period;
+}
+
+fract32 Aleph_PitchDetectorYIN_get_confidence(
+    Aleph_PitchDetectorYIN *const pitch_detect) {
+
+    t_Aleph_PitchDetectorYIN *pd = *pitch_detect;
+
+    return pd->confidence;
+}
+
+void Aleph_PitchDetectorYIN_set_threshold(
+    Aleph_PitchDetectorYIN *const pitch_detect, fix16 threshold) {
+
+    t_Aleph_PitchDetectorYIN *pd = *pitch_detect;
+
+    pd->threshold = threshold;
+}
+
+/*----- Static function implementations ------------------------------*/
+
+// Divisions happen here, once every 16 zero crossings.
+static void _set_period(t_Aleph_PitchDetector *pd, fract32 period) {
+
+    fract32 centre_freq = FR32_MAX / period;
+
+    pd->current_period = period;
+
+    Aleph_LPF_set_freq(
+        &(pd->adaptive_filter),
+        shl_fr1x32(centre_freq, ALEPH_PITCH_DETECTOR_RADIX_INTERNAL + 3));
+
+    Aleph_HPF_set_freq(
+        &(pd->dcblocker),
+        shl_fr1x32(centre_freq, ALEPH_PITCH_DETECTOR_RADIX_INTERNAL - 3));
+
+    pd->osc_inc =
+        (pd->pitch_offset /
+         shl_fr1x32(period, -ALEPH_PITCH_DETECTOR_RADIX_INTERNAL))
+        << 3;
+}
+
+static inline void _track(t_Aleph_PitchDetector *pd, fract32 in) {
+
+    in = Aleph_LPF_next_precise(&(pd->adaptive_filter), in);
+    in = Aleph_HPF_next_precise(&(pd->dcblocker), in);
 
     if (pd->last_in <= 0 && in >= 0 && pd->nframes > 12) {
         pd->period = add_fr1x32(pd->period, min_fr1x32(pd->nframes, 2048));
         pd->nframes = 0;
         pd->nsamples += 1;
         if (pd->nsamples >= (1 << ALEPH_PITCH_DETECTOR_RADIX_INTERNAL)) {
-            pd->current_period = pd->period;
+            _set_period(pd, pd->period);
             pd->period = 0;
             pd->nsamples = 0;
         }
     }
     pd->nframes += 1;
     pd->last_in = in;
+}
 
-    return (shl_fr1x32(pd->current_period,
-                       ALEPH_PITCH_DETECTOR_RADIX_EXTERNAL -
-                           ALEPH_PITCH_DETECTOR_RADIX_INTERNAL));
+static inline fract32 _osc_shape(e_Aleph_Oscillator_shape shape,
+                                 fract32 phase) {
+
+    switch (shape) {
+
+    case ALEPH_OSCILLATOR_SHAPE_TRIANGLE:
+        return osc_triangle(phase);
+
+    case ALEPH_OSCILLATOR_SHAPE_SAW:
+        return phase;
+
+    case ALEPH_OSCILLATOR_SHAPE_SQUARE:
+        return osc_square(phase);
+
+    default:
+        return osc_sin(phase);
+    }
 }
 
-/// TODO: Select waveform shape.
-//
-fract32 Aleph_PitchDetector_osc_next(Aleph_PitchDetector *const pitch_detect) {
+static void _yin_push(t_Aleph_PitchDetectorYIN *pd, fract16 in) {
 
-    t_Aleph_PitchDetector *pd = *pitch_detect;
+    int i;
 
-    // Debug uncomment the line below to force 1k tone
-    /* pd->current_period = (48 << (ALEPH_PITCH_DETECTOR_RADIX_INTERNAL)); */
+    pd->incoming[pd->count++] = in;
 
-    pd->phase +=
-        (pd->pitch_offset /
-         shl_fr1x32(pd->current_period, -ALEPH_PITCH_DETECTOR_RADIX_INTERNAL))
-        << 3;
+    // Start analysis of a full frame, then slide by one hop.
+    if (pd->count == ALEPH_YIN_FRAME) {
+
+        for (i = 0; i < ALEPH_YIN_FRAME; i++) {
+            pd->frame[i] = pd->incoming[i];
+        }
+
+        for (i = 0; i < ALEPH_YIN_FRAME - ALEPH_YIN_HOP; i++) {
+            pd->incoming[i] = pd->incoming[i + ALEPH_YIN_HOP];
+        }
 
-    return osc_sin(pd->phase);
+        pd->count = ALEPH_YIN_FRAME - ALEPH_YIN_HOP;
+
+        pd->cmndf[0] = 1 << 16;
+        pd->running_sum = 0;
+        pd->lag = 1;
+        pd->analysing = true;
+    }
+
+    if (pd->analysing) {
+
+        for (i = 0; i < ALEPH_YIN_LAGS_PER_SAMPLE; i++) {
+
+            _yin_lag(pd);
+
+            if (pd->lag > ALEPH_YIN_MAX_LAG) {
+                _yin_publish(pd);
+                pd->analysing = false;
+                break;
+            }
+        }
+    }
 }
 
-/// TODO: Convenience function to track and return oscillator in one call.
+// Difference function at one lag, normalised by its cumulative mean.
+static void _yin_lag(t_Aleph_PitchDetectorYIN *pd) {
 
-/*----- Static function implementations ------------------------------*/
+    fract16 *x = pd->frame;
+    fract16 *y = pd->frame + pd->lag;
+    int64_t diff_sum = 0;
+    int64_t num;
+    int32_t diff;
+
+    int i;
+    for (i = 0; i < ALEPH_YIN_WINDOW; i++) {
+        diff = x[i] - y[i];
+        diff_sum += (int64_t)diff * diff;
+    }
+
+    pd->running_sum += diff_sum;
+
+    // d'(lag) = d(lag) * lag / sum(d(1..lag))
+    num = diff_sum * pd->lag;
+
+    if (pd->running_sum == 0) {
+        pd->cmndf[pd->lag] = 1 << 16;
+    } else if (pd->running_sum > ((int64_t)1 << 32)) {
+        pd->cmndf[pd->lag] = (fix16)(num / (pd->running_sum >> 16));
+    } else {
+        pd->cmndf[pd->lag] = (fix16)((num << 16) / pd->running_sum);
+    }
+
+    pd->lag++;
+}
+
+static void _yin_publish(t_Aleph_PitchDetectorYIN *pd) {
+
+    fix16 *d = pd->cmndf;
+    fix16 a, b, c, denom;
+    int best = ALEPH_YIN_MIN_LAG;
+    int tau;
+    int64_t offset = 0;
+
+    // First dip below threshold, else the global minimum.
+    for (tau = ALEPH_YIN_MIN_LAG; tau < ALEPH_YIN_MAX_LAG; tau++) {
+
+        if (d[tau] < pd->threshold) {
+            while (tau < ALEPH_YIN_MAX_LAG - 1 && d[tau + 1] < d[tau]) {
+                tau++;
+            }
+            best = tau;
+            break;
+        }
+
+        if (d[tau] < d[best]) {
+            best = tau;
+        }
+    }
+
+    // Parabolic interpolation of the minimum.
+    a = d[best - 1];
+    b = d[best];
+    c = d[best + 1];
+    denom = a - 2 * b + c;
+
+    if (denom > 0) {
+        offset = ((int64_t)(a - c) << 15) / denom;
+    }
+
+    if (b < (1 << 16)) {
+        pd->confidence = shl_fr1x32((1 << 16) - b, 15);
+    } else {
+        pd->confidence = 0;
+    }
+
+    pd->period = (fix16)((((int64_t)best << 16) + offset) *
+                         ALEPH_YIN_DECIMATION);
+}
 
 /*----- End of file --------------------------------------------------*/
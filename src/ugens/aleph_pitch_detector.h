@@ -20,6 +20,11 @@
  * @file    aleph_pitch_detector.h
  *
  * @brief   Public API for pitch detection.
+ *
+ *          Aleph_PitchDetector tracks zero crossings, it is cheap but can
+ *          lock onto harmonics. Aleph_PitchDetectorYIN runs the YIN
+ *          difference function on decimated input, spread over audio
+ *          blocks, and publishes a period with a confidence.
  */
 
 #ifndef ALEPH_PITCH_DETECTOR_H
@@ -34,6 +39,8 @@ extern "C" {
 #include "aleph.h"
 
 #include "aleph_filter.h"
+#include "aleph_oscillator.h"
+#include "aleph_oversampler.h"
 
 /*----- Macros -------------------------------------------------------*/
 
@@ -42,6 +49,21 @@ extern "C" {
 #define ALEPH_PITCH_DETECTOR_RADIX_TOTAL                                       \
     (ALEPH_PITCH_DETECTOR_RADIX_INTERNAL + ALEPH_PITCH_DETECTOR_RADIX_EXTERNAL)
 
+// Lags and window in decimated samples.
+#define ALEPH_YIN_DECIMATION (4)
+#define ALEPH_YIN_WINDOW (256)
+#define ALEPH_YIN_MIN_LAG (4)
+#define ALEPH_YIN_MAX_LAG (256)
+#define ALEPH_YIN_HOP (128)
+#define ALEPH_YIN_FRAME (ALEPH_YIN_WINDOW + ALEPH_YIN_MAX_LAG)
+
+// Lags computed per decimated sample, analysis finishes within one hop.
+#define ALEPH_YIN_LAGS_PER_SAMPLE                                              \
+    ((ALEPH_YIN_MAX_LAG + ALEPH_YIN_HOP - 1) / ALEPH_YIN_HOP)
+
+// Cumulative mean normalised difference as fix16.
+#define ALEPH_YIN_DEFAULT_THRESHOLD (0x2666)
+
 /*----- Typedefs -----------------------------------------------------*/
 
 typedef struct {
@@ -55,10 +77,29 @@ typedef struct {
     int32_t nsamples;
     int32_t nframes;
     fract32 pitch_offset;
+    fract32 osc_inc;
+    e_Aleph_Oscillator_shape shape;
 } t_Aleph_PitchDetector;
 
 typedef t_Aleph_PitchDetector *Aleph_PitchDetector;
 
+typedef struct {
+    Mempool mempool;
+    Aleph_Oversampler decimator;
+    fract16 incoming[ALEPH_YIN_FRAME];
+    fract16 frame[ALEPH_YIN_FRAME];
+    fix16 cmndf[ALEPH_YIN_MAX_LAG + 1];
+    int64_t running_sum;
+    uint16_t count;
+    uint16_t lag;
+    bool analysing;
+    fix16 threshold;
+    fix16 period;
+    fract32 confidence;
+} t_Aleph_PitchDetectorYIN;
+
+typedef t_Aleph_PitchDetectorYIN *Aleph_PitchDetectorYIN;
+
 /*----- Extern variable declarations ---------------------------------*/
 
 /*----- Extern function prototypes -----------------------------------*/
@@ -76,6 +117,42 @@ fract32 Aleph_PitchDetector_track_next(Aleph_PitchDetector *const pitch_detect,
 
 fract32 Aleph_PitchDetector_osc_next(Aleph_PitchDetector *const pitch_detect);
 
+// Returns the measured period at the end of the block.
+fract32
+Aleph_PitchDetector_track_next_block(Aleph_PitchDetector *const pitch_detect,
+                                     fract32 *input, size_t size);
+
+void Aleph_PitchDetector_osc_next_block(Aleph_PitchDetector *const pitch_detect,
+                                        fract32 *output, size_t size);
+
+void Aleph_PitchDetector_set_shape(Aleph_PitchDetector *const pitch_detect,
+                                   e_Aleph_Oscillator_shape shape);
+
+void Aleph_PitchDetector_set_pitch_offset(
+    Aleph_PitchDetector *const pitch_detect, fract32 pitch_offset);
+
+void Aleph_PitchDetectorYIN_init(Aleph_PitchDetectorYIN *const pitch_detect,
+                                 t_Aleph *const aleph);
+void Aleph_PitchDetectorYIN_init_to_pool(
+    Aleph_PitchDetectorYIN *const pitch_detect, Mempool *const mempool);
+void Aleph_PitchDetectorYIN_free(Aleph_PitchDetectorYIN *const pitch_detect);
+
+void Aleph_PitchDetectorYIN_reset(Aleph_PitchDetectorYIN *const pitch_detect);
+
+// Size must be a multiple of ALEPH_YIN_DECIMATION.
+void Aleph_PitchDetectorYIN_next_block(
+    Aleph_PitchDetectorYIN *const pitch_detect, fract32 *input, size_t size);
+
+// Period in samples at the input rate, as fix16.
+fix16 Aleph_PitchDetectorYIN_get_period(
+    Aleph_PitchDetectorYIN *const pitch_detect);
+
+fract32 Aleph_PitchDetectorYIN_get_confidence(
+    Aleph_PitchDetectorYIN *const pitch_detect);
+
+void Aleph_PitchDetectorYIN_set_threshold(
+    Aleph_PitchDetectorYIN *const pitch_detect, fix16 threshold);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,411 @@
+/*----------------------------------------------------------------------
+
+                     This file is part of Aleph DSP
+
+                https://github.com/bangcorrupt/aleph-dsp
+
+         Aleph DSP is based on monome/aleph and spiricom/LEAF.
+
+                              MIT License
+
+            Aleph dedicated to the public domain by monome.
+
+                LEAF Copyright Jeff Snyder et. al. 2020
+
+                       Copyright bangcorrupt 2024
+
+----------------------------------------------------------------------*/
+/**
+ * @file    aleph_polysynth.c
+ *
+ * @brief   Polyphonic voice allocation.
+ *
+ *          All allocation and voice bookkeeping happens on note events or
+ *          once per block, never per sample.
+ */
+
+/*----- Includes -----------------------------------------------------*/
+
+#include "aleph.h"
+
+#include "aleph_monosynth.h"
+#include "aleph_utils.h"
+
+#include "aleph_polysynth.h"
+
+/*----- Macros -------------------------------------------------------*/
+
+#define ALEPH_POLYSYNTH_FADE_STEP (FR32_MAX / ALEPH_POLYSYNTH_FADE_SIZE)
+
+/*----- Typedefs -----------------------------------------------------*/
+
+/*----- Static variable definitions ----------------------------------*/
+
+/*----- Extern variable definitions ----------------------------------*/
+
+/*----- Static function prototypes -----------------------------------*/
+
+static void _render_block(t_Aleph_PolySynth *ps, fract32 *output,
+                          size_t size);
+static void _fade_out(t_Aleph_PolySynth *ps, uint8_t v, fract32 *row,
+                      size_t size);
+static void _start_next(t_Aleph_PolySynth *ps, uint8_t v);
+static void _start_note(t_Aleph_PolySynth *ps, uint8_t v, uint8_t note,
+                        fract32 freq);
+static uint8_t _find_free(t_Aleph_PolySynth *ps, uint8_t note);
+static uint8_t _find_steal(t_Aleph_PolySynth *ps);
+
+/*----- Extern function implementations ------------------------------*/
+
+void Aleph_PolySynth_init(Aleph_PolySynth *const poly, uint8_t num_voices,
+                          t_Aleph *const aleph) {
+
+    Aleph_PolySynth_init_to_pool(poly, num_voices, &aleph->mempool);
+}
+
+void Aleph_PolySynth_init_to_pool(Aleph_PolySynth *const poly,
+                                  uint8_t num_voices, Mempool *const mempool) {
+
+    t_Mempool *mp = *mempool;
+
+    t_Aleph_PolySynth *ps = *poly =
+        (t_Aleph_PolySynth *)mpool_alloc(sizeof(t_Aleph_PolySynth), mp);
+
+    ps->mempool = mp;
+
+    ps->num_voices = num_voices;
+    ps->steal = ALEPH_POLYSYNTH_STEAL_OLDEST;
+    ps->clock = 0;
+
+    ps->voice = (Aleph_MonoSynth *)mpool_calloc(
+        sizeof(Aleph_MonoSynth) * num_voices, mp);
+
+    ps->state = (uint8_t *)mpool_calloc(sizeof(uint8_t) * num_voices, mp);
+    ps->note = (uint8_t *)mpool_calloc(sizeof(uint8_t) * num_voices, mp);
+    ps->age = (uint32_t *)mpool_calloc(sizeof(uint32_t) * num_voices, mp);
+    ps->fade = (uint16_t *)mpool_calloc(sizeof(uint16_t) * num_voices, mp);
+    ps->next_note = (uint8_t *)mpool_calloc(sizeof(uint8_t) * num_voices, mp);
+    ps->next_freq = (fract32 *)mpool_calloc(sizeof(fract32) * num_voices, mp);
+
+    ps->scratch = (fract32 *)mpool_calloc(
+        sizeof(fract32) * ALEPH_MONOSYNTH_BLOCK_SIZE * num_voices, mp);
+
+    ps->mix = (fract32 **)mpool_calloc(sizeof(fract32 *) * num_voices, mp);
+
+    int v;
+    for (v = 0; v < num_voices; v++) {
+
+        Aleph_MonoSynth_init_to_pool(&ps->voice[v], mempool);
+
+        ps->state[v] = ALEPH_POLYSYNTH_VOICE_RELEASED;
+        ps->note[v] = ALEPH_POLYSYNTH_NO_NOTE;
+        ps->next_note[v] = ALEPH_POLYSYNTH_NO_NOTE;
+    }
+}
+
+void Aleph_PolySynth_free(Aleph_PolySynth *const poly) {
+
+    t_Aleph_PolySynth *ps = *poly;
+
+    int v;
+    for (v = 0; v < ps->num_voices; v++) {
+        Aleph_MonoSynth_free(&ps->voice[v]);
+    }
+
+    mpool_free((char *)ps->mix, ps->mempool);
+    mpool_free((char *)ps->scratch, ps->mempool);
+    mpool_free((char *)ps->next_freq, ps->mempool);
+    mpool_free((char *)ps->next_note, ps->mempool);
+    mpool_free((char *)ps->fade, ps->mempool);
+    mpool_free((char *)ps->age, ps->mempool);
+    mpool_free((char *)ps->note, ps->mempool);
+    mpool_free((char *)ps->state, ps->mempool);
+    mpool_free((char *)ps->voice, ps->mempool);
+
+    mpool_free((char *)ps, ps->mempool);
+}
+
+void Aleph_PolySynth_next_block(Aleph_PolySynth *const poly, fract32 *output,
+                                size_t size) {
+
+    t_Aleph_PolySynth *ps = *poly;
+
+    size_t block;
+
+    while (size > 0) {
+
+        block = size < ALEPH_MONOSYNTH_BLOCK_SIZE ? size
+                                                  : ALEPH_MONOSYNTH_BLOCK_SIZE;
+
+        _render_block(ps, output, block);
+
+        output += block;
+        size -= block;
+    }
+}
+
+uint8_t Aleph_PolySynth_note_on(Aleph_PolySynth *const poly, uint8_t note,
+                                fract32 freq) {
+
+    t_Aleph_PolySynth *ps = *poly;
+
+    uint8_t v = _find_free(ps, note);
+
+    if (v != ALEPH_POLYSYNTH_NO_VOICE) {
+        _start_note(ps, v, note, freq);
+        return v;
+    }
+
+    v = _find_steal(ps);
+
+    if (v != ALEPH_POLYSYNTH_NO_VOICE) {
+
+        // A voice already fading keeps its fade, only the next note changes.
+        if (ps->state[v] != ALEPH_POLYSYNTH_VOICE_STEALING) {
+            ps->state[v] = ALEPH_POLYSYNTH_VOICE_STEALING;
+            ps->fade[v] = ALEPH_POLYSYNTH_FADE_SIZE;
+        }
+
+        ps->next_note[v] = note;
+        ps->next_freq[v] = freq;
+        ps->age[v] = ps->clock++;
+    }
+
+    return v;
+}
+
+void Aleph_PolySynth_note_off(Aleph_PolySynth *const poly, uint8_t note) {
+
+    t_Aleph_PolySynth *ps = *poly;
+
+    int v;
+    for (v = 0; v < ps->num_voices; v++) {
+
+        if (ps->state[v] == ALEPH_POLYSYNTH_VOICE_ON && ps->note[v] == note) {
+            Aleph_MonoSynth_set_gate(&ps->voice[v], false);
+            ps->state[v] = ALEPH_POLYSYNTH_VOICE_RELEASED;
+        }
+
+        // Released before the fade finished, voice will just go quiet.
+        if (ps->state[v] == ALEPH_POLYSYNTH_VOICE_STEALING &&
+            ps->next_note[v] == note) {
+            ps->next_note[v] = ALEPH_POLYSYNTH_NO_NOTE;
+        }
+    }
+}
+
+void Aleph_PolySynth_all_notes_off(Aleph_PolySynth *const poly, bool hard) {
+
+    t_Aleph_PolySynth *ps = *poly;
+
+    int v;
+    for (v = 0; v < ps->num_voices; v++) {
+
+        if (hard) {
+            Aleph_MonoSynth_reset(&ps->voice[v]);
+            ps->state[v] = ALEPH_POLYSYNTH_VOICE_RELEASED;
+
+        } else if (ps->state[v] == ALEPH_POLYSYNTH_VOICE_ON) {
+            Aleph_MonoSynth_set_gate(&ps->voice[v], false);
+            ps->state[v] = ALEPH_POLYSYNTH_VOICE_RELEASED;
+        }
+
+        ps->next_note[v] = ALEPH_POLYSYNTH_NO_NOTE;
+    }
+}
+
+void Aleph_PolySynth_set_steal(Aleph_PolySynth *const poly,
+                               e_Aleph_PolySynth_steal steal) {
+
+    t_Aleph_PolySynth *ps = *poly;
+
+    ps->steal = steal;
+}
+
+Aleph_MonoSynth *Aleph_PolySynth_get_voice(Aleph_PolySynth *const poly,
+                                           uint8_t index) {
+
+    t_Aleph_PolySynth *ps = *poly;
+
+    return &ps->voice[index];
+}
+
+uint8_t Aleph_PolySynth_get_num_active(Aleph_PolySynth *const poly) {
+
+    t_Aleph_PolySynth *ps = *poly;
+
+    uint8_t count = 0;
+
+    int v;
+    for (v = 0; v < ps->num_voices; v++) {
+        if (!Aleph_MonoSynth_is_idle(&ps->voice[v])) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/*----- Static function implementations ------------------------------*/
+
+// Render each sounding voice into its own row, then sum the rows.
+static void _render_block(t_Aleph_PolySynth *ps, fract32 *output,
+                          size_t size) {
+
+    fract32 *row;
+    int64_t acc;
+    uint8_t num_mix = 0;
+
+    int v, k, i;
+    for (v = 0; v < ps->num_voices; v++) {
+
+        if (Aleph_MonoSynth_is_idle(&ps->voice[v])) {
+
+            // Stolen voice released to silence before the fade finished.
+            if (ps->state[v] != ALEPH_POLYSYNTH_VOICE_STEALING) {
+                continue;
+            }
+
+            _start_next(ps, v);
+
+            if (Aleph_MonoSynth_is_idle(&ps->voice[v])) {
+                continue;
+            }
+        }
+
+        row = ps->scratch + v * ALEPH_MONOSYNTH_BLOCK_SIZE;
+
+        Aleph_MonoSynth_next_block(&ps->voice[v], row, size);
+
+        if (ps->state[v] == ALEPH_POLYSYNTH_VOICE_STEALING) {
+            _fade_out(ps, v, row, size);
+        }
+
+        ps->mix[num_mix++] = row;
+    }
+
+    for (i = 0; i < size; i++) {
+
+        acc = 0;
+
+        for (k = 0; k < num_mix; k++) {
+            acc += ps->mix[k][i];
+        }
+
+        output[i] = sat_fr32(acc);
+    }
+}
+
+// Linear fade to silence, starts the next note once it completes.
+static void _fade_out(t_Aleph_PolySynth *ps, uint8_t v, fract32 *row,
+                      size_t size) {
+
+    uint16_t fade = ps->fade[v];
+
+    int i;
+    for (i = 0; i < size; i++) {
+
+        if (fade > 0) {
+            fade--;
+        }
+
+        row[i] = mult_fr1x32x32(row[i], fade * ALEPH_POLYSYNTH_FADE_STEP);
+    }
+
+    ps->fade[v] = fade;
+
+    if (fade == 0) {
+        _start_next(ps, v);
+    }
+}
+
+static void _start_next(t_Aleph_PolySynth *ps, uint8_t v) {
+
+    Aleph_MonoSynth_reset(&ps->voice[v]);
+
+    if (ps->next_note[v] != ALEPH_POLYSYNTH_NO_NOTE) {
+
+        _start_note(ps, v, ps->next_note[v], ps->next_freq[v]);
+        ps->next_note[v] = ALEPH_POLYSYNTH_NO_NOTE;
+
+    } else {
+        ps->state[v] = ALEPH_POLYSYNTH_VOICE_RELEASED;
+    }
+}
+
+static void _start_note(t_Aleph_PolySynth *ps, uint8_t v, uint8_t note,
+                        fract32 freq) {
+
+    Aleph_MonoSynth_set_freq(&ps->voice[v], freq);
+    Aleph_MonoSynth_set_gate(&ps->voice[v], true);
+
+    ps->state[v] = ALEPH_POLYSYNTH_VOICE_ON;
+    ps->note[v] = note;
+    ps->age[v] = ps->clock++;
+}
+
+// Voice already sounding the note, or else the first idle voice.
+static uint8_t _find_free(t_Aleph_PolySynth *ps, uint8_t note) {
+
+    uint8_t idle = ALEPH_POLYSYNTH_NO_VOICE;
+
+    int v;
+    for (v = 0; v < ps->num_voices; v++) {
+
+        if (ps->state[v] == ALEPH_POLYSYNTH_VOICE_STEALING) {
+            continue;
+        }
+
+        if (ps->note[v] == note && !Aleph_MonoSynth_is_idle(&ps->voice[v])) {
+            return v;
+        }
+
+        if (idle == ALEPH_POLYSYNTH_NO_VOICE &&
+            Aleph_MonoSynth_is_idle(&ps->voice[v])) {
+            idle = v;
+        }
+    }
+
+    return idle;
+}
+
+// Oldest or quietest voice, voices already fading only when nothing else.
+static uint8_t _find_steal(t_Aleph_PolySynth *ps) {
+
+    uint8_t steal = ALEPH_POLYSYNTH_NO_VOICE;
+    bool stealing = true;
+    bool is_stealing;
+    uint32_t age;
+    uint32_t best_age = 0;
+    fract32 level;
+    fract32 best_level = FR32_MAX;
+
+    int v;
+    for (v = 0; v < ps->num_voices; v++) {
+
+        is_stealing = ps->state[v] == ALEPH_POLYSYNTH_VOICE_STEALING;
+
+        if (is_stealing && !stealing) {
+            continue;
+        }
+
+        // Clock wraps, compare elapsed counts.
+        age = ps->clock - ps->age[v];
+        level = Aleph_MonoSynth_get_level(&ps->voice[v]);
+
+        if (steal == ALEPH_POLYSYNTH_NO_VOICE || (stealing && !is_stealing) ||
+            (ps->steal == ALEPH_POLYSYNTH_STEAL_OLDEST && age > best_age) ||
+            (ps->steal == ALEPH_POLYSYNTH_STEAL_QUIETEST &&
+             level < best_level)) {
+
+            steal = v;
+            stealing = is_stealing;
+            best_age = age;
+            best_level = level;
+        }
+    }
+
+    return steal;
+}
+
+/*----- End of file --------------------------------------------------*/
@@ -0,0 +1,116 @@
+/*----------------------------------------------------------------------
+
+                     This file is part of Aleph DSP
+
+                https://github.com/bangcorrupt/aleph-dsp
+
+         Aleph DSP is based on monome/aleph and spiricom/LEAF.
+
+                              MIT License
+
+            Aleph dedicated to the public domain by monome.
+
+                LEAF Copyright Jeff Snyder et. al. 2020
+
+                       Copyright bangcorrupt 2024
+
+----------------------------------------------------------------------*/
+/**
+ * @file    aleph_polysynth.h
+ *
+ * @brief   Public API for polyphonic voice allocation.
+ *
+ *          Owns a runtime number of Aleph_MonoSynth voices. Notes go to an
+ *          idle voice, or steal one by age or level after a short fade.
+ *          Only sounding voices are rendered, then mixed in one pass.
+ */
+
+#ifndef ALEPH_POLYSYNTH_H
+#define ALEPH_POLYSYNTH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*----- Includes -----------------------------------------------------*/
+
+#include "aleph.h"
+
+#include "aleph_monosynth.h"
+
+/*----- Macros -------------------------------------------------------*/
+
+// Fade out length for a stolen voice, in samples.
+#define ALEPH_POLYSYNTH_FADE_SIZE (64)
+
+#define ALEPH_POLYSYNTH_NO_VOICE (0xFF)
+#define ALEPH_POLYSYNTH_NO_NOTE (0xFF)
+
+/*----- Typedefs -----------------------------------------------------*/
+
+typedef enum {
+    ALEPH_POLYSYNTH_STEAL_OLDEST,
+    ALEPH_POLYSYNTH_STEAL_QUIETEST,
+} e_Aleph_PolySynth_steal;
+
+typedef enum {
+    ALEPH_POLYSYNTH_VOICE_ON,
+    ALEPH_POLYSYNTH_VOICE_RELEASED,
+    ALEPH_POLYSYNTH_VOICE_STEALING,
+} e_Aleph_PolySynth_voice_state;
+
+// Structure of arrays, one lane per voice.
+typedef struct {
+    Mempool mempool;
+    uint8_t num_voices;
+    e_Aleph_PolySynth_steal steal;
+    uint32_t clock; // Note on count, orders voices by age.
+    Aleph_MonoSynth *voice;
+    uint8_t *state;
+    uint8_t *note;
+    uint32_t *age;
+    uint16_t *fade; // Samples of fade out remaining.
+    uint8_t *next_note;
+    fract32 *next_freq;
+    fract32 *scratch; // One ALEPH_MONOSYNTH_BLOCK_SIZE row per voice.
+    fract32 **mix;
+} t_Aleph_PolySynth;
+
+typedef t_Aleph_PolySynth *Aleph_PolySynth;
+
+/*----- Extern variable declarations ---------------------------------*/
+
+/*----- Extern function prototypes -----------------------------------*/
+
+void Aleph_PolySynth_init(Aleph_PolySynth *const poly, uint8_t num_voices,
+                          t_Aleph *const aleph);
+void Aleph_PolySynth_init_to_pool(Aleph_PolySynth *const poly,
+                                  uint8_t num_voices, Mempool *const mempool);
+void Aleph_PolySynth_free(Aleph_PolySynth *const poly);
+
+void Aleph_PolySynth_next_block(Aleph_PolySynth *const poly, fract32 *output,
+                                size_t size);
+
+// Returns the voice allocated to the note.
+uint8_t Aleph_PolySynth_note_on(Aleph_PolySynth *const poly, uint8_t note,
+                                fract32 freq);
+void Aleph_PolySynth_note_off(Aleph_PolySynth *const poly, uint8_t note);
+
+// Release all notes, or silence all voices immediately when `hard`.
+void Aleph_PolySynth_all_notes_off(Aleph_PolySynth *const poly, bool hard);
+
+void Aleph_PolySynth_set_steal(Aleph_PolySynth *const poly,
+                               e_Aleph_PolySynth_steal steal);
+
+// Voice handle, for setting parameters.
+Aleph_MonoSynth *Aleph_PolySynth_get_voice(Aleph_PolySynth *const poly,
+                                           uint8_t index);
+
+uint8_t Aleph_PolySynth_get_num_active(Aleph_PolySynth *const poly);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+/*----- End of file --------------------------------------------------*/
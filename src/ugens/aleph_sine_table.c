@@ -0,0 +1,150 @@
+/*----------------------------------------------------------------------
+
+                     This file is part of Aleph DSP
+
+                https://github.com/bangcorrupt/aleph-dsp
+
+         Aleph DSP is based on monome/aleph and spiricom/LEAF.
+
+                              MIT License
+
+            Aleph dedicated to the public domain by monome.
+
+                LEAF Copyright Jeff Snyder et. al. 2020
+
+                       Copyright bangcorrupt 2024
+
+----------------------------------------------------------------------*/
+
+/**
+ * @file    aleph_sine_table.c
+ *
+ * @brief   Table based sine and cosine.
+ */
+
+/*----- Includes -----------------------------------------------------*/
+
+#include <stdint.h>
+
+#include "aleph.h"
+
+#include "aleph_sine_table.h"
+
+/*----- Macros -------------------------------------------------------*/
+
+#define SINE_TABLE_FRAC_BITS (30 - ALEPH_SINE_TABLE_BITS)
+#define SINE_TABLE_FRAC_MASK ((1 << SINE_TABLE_FRAC_BITS) - 1)
+
+/*----- Typedefs -----------------------------------------------------*/
+
+/*----- Static variable definitions ----------------------------------*/
+
+// sin(x) for x in [0, pi/2], ALEPH_SINE_TABLE_SIZE + 1 points.
+static const fract32 s_sine_table[ALEPH_SINE_TABLE_SIZE + 1] = {
+    0x00000000, 0x00C90F88, 0x01921D20, 0x025B26D7,
+    0x03242ABF, 0x03ED26E6, 0x04B6195D, 0x057F0035,
+    0x0647D97C, 0x0710A345, 0x07D95B9E, 0x08A2009A,
+    0x096A9049, 0x0A3308BD, 0x0AFB6805, 0x0BC3AC35,
+    0x0C8BD35E, 0x0D53DB92, 0x0E1BC2E4, 0x0EE38766,
+    0x0FAB272B, 0x1072A048, 0x1139F0CF, 0x120116D5,
+    0x12C8106F, 0x138EDBB1, 0x145576B1, 0x151BDF86,
+    0x15E21445, 0x16A81305, 0x176DD9DE, 0x183366E9,
+    0x18F8B83C, 0x19BDCBF3, 0x1A82A026, 0x1B4732EF,
+    0x1C0B826A, 0x1CCF8CB3, 0x1D934FE5, 0x1E56CA1E,
+    0x1F19F97B, 0x1FDCDC1B, 0x209F701C, 0x2161B3A0,
+    0x2223A4C5, 0x22E541AF, 0x23A6887F, 0x24677758,
+    0x25280C5E, 0x25E845B6, 0x26A82186, 0x27679DF4,
+    0x2826B928, 0x28E5714B, 0x29A3C485, 0x2A61B101,
+    0x2B1F34EB, 0x2BDC4E6F, 0x2C98FBBA, 0x2D553AFC,
+    0x2E110A62, 0x2ECC681E, 0x2F875262, 0x3041C761,
+    0x30FBC54D, 0x31B54A5E, 0x326E54C7, 0x3326E2C3,
+    0x33DEF287, 0x34968250, 0x354D9057, 0x36041AD9,
+    0x36BA2014, 0x376F9E46, 0x382493B0, 0x38D8FE93,
+    0x398CDD32, 0x3A402DD2, 0x3AF2EEB7, 0x3BA51E29,
+    0x3C56BA70, 0x3D07C1D6, 0x3DB832A6, 0x3E680B2C,
+    0x3F1749B8, 0x3FC5EC98, 0x4073F21D, 0x4121589B,
+    0x41CE1E65, 0x427A41D0, 0x4325C135, 0x43D09AED,
+    0x447ACD50, 0x452456BD, 0x45CD358F, 0x46756828,
+    0x471CECE7, 0x47C3C22F, 0x4869E665, 0x490F57EE,
+    0x49B41533, 0x4A581C9E, 0x4AFB6C98, 0x4B9E0390,
+    0x4C3FDFF4, 0x4CE10034, 0x4D8162C4, 0x4E210617,
+    0x4EBFE8A5, 0x4F5E08E3, 0x4FFB654D, 0x5097FC5E,
+    0x5133CC94, 0x51CED46E, 0x5269126E, 0x53028518,
+    0x539B2AF0, 0x5433027D, 0x54CA0A4B, 0x556040E2,
+    0x55F5A4D2, 0x568A34A9, 0x571DEEFA, 0x57B0D256,
+    0x5842DD54, 0x58D40E8C, 0x59646498, 0x59F3DE12,
+    0x5A82799A, 0x5B1035CF, 0x5B9D1154, 0x5C290ACC,
+    0x5CB420E0, 0x5D3E5237, 0x5DC79D7C, 0x5E50015D,
+    0x5ED77C8A, 0x5F5E0DB3, 0x5FE3B38D, 0x60686CCF,
+    0x60EC3830, 0x616F146C, 0x61F1003F, 0x6271FA69,
+    0x62F201AC, 0x637114CC, 0x63EF3290, 0x646C59BF,
+    0x64E88926, 0x6563BF92, 0x65DDFBD3, 0x66573CBB,
+    0x66CF8120, 0x6746C7D8, 0x67BD0FBD, 0x683257AB,
+    0x68A69E81, 0x6919E320, 0x698C246C, 0x69FD614A,
+    0x6A6D98A4, 0x6ADCC964, 0x6B4AF279, 0x6BB812D1,
+    0x6C242960, 0x6C8F351C, 0x6CF934FC, 0x6D6227FA,
+    0x6DCA0D14, 0x6E30E34A, 0x6E96A99D, 0x6EFB5F12,
+    0x6F5F02B2, 0x6FC19385, 0x7023109A, 0x708378FF,
+    0x70E2CBC6, 0x71410805, 0x719E2CD2, 0x71FA3949,
+    0x72552C85, 0x72AF05A7, 0x7307C3D0, 0x735F6626,
+    0x73B5EBD1, 0x740B53FB, 0x745F9DD1, 0x74B2C884,
+    0x7504D345, 0x7555BD4C, 0x75A585CF, 0x75F42C0B,
+    0x7641AF3D, 0x768E0EA6, 0x76D94989, 0x77235F2D,
+    0x776C4EDB, 0x77B417DF, 0x77FAB989, 0x78403329,
+    0x78848414, 0x78C7ABA2, 0x7909A92D, 0x794A7C12,
+    0x798A23B1, 0x79C89F6E, 0x7A05EEAD, 0x7A4210D8,
+    0x7A7D055B, 0x7AB6CBA4, 0x7AEF6323, 0x7B26CB4F,
+    0x7B5D039E, 0x7B920B89, 0x7BC5E290, 0x7BF88830,
+    0x7C29FBEE, 0x7C5A3D50, 0x7C894BDE, 0x7CB72724,
+    0x7CE3CEB2, 0x7D0F4218, 0x7D3980EC, 0x7D628AC6,
+    0x7D8A5F40, 0x7DB0FDF8, 0x7DD6668F, 0x7DFA98A8,
+    0x7E1D93EA, 0x7E3F57FF, 0x7E5FE493, 0x7E7F3957,
+    0x7E9D55FC, 0x7EBA3A39, 0x7ED5E5C6, 0x7EF05860,
+    0x7F0991C4, 0x7F2191B4, 0x7F3857F6, 0x7F4DE451,
+    0x7F62368F, 0x7F754E80, 0x7F872BF3, 0x7F97CEBD,
+    0x7FA736B4, 0x7FB563B3, 0x7FC25596, 0x7FCE0C3E,
+    0x7FD8878E, 0x7FE1C76B, 0x7FE9CBC0, 0x7FF09478,
+    0x7FF62182, 0x7FFA72D1, 0x7FFD885A, 0x7FFF6216,
+    0x7FFFFFFF,
+};
+
+/*----- Extern variable definitions ----------------------------------*/
+
+/*----- Static function prototypes -----------------------------------*/
+
+/*----- Extern function implementations ------------------------------*/
+
+fract32 sine_lookup(int32_t phase) {
+    uint32_t quadrant = (uint32_t)phase >> 30;
+    uint32_t pos = (uint32_t)phase & (ALEPH_SINE_QUARTER_PHASE - 1);
+    uint32_t idx;
+    fract32 frac;
+    fract32 ret;
+
+    // Mirror odd quadrants, off by one LSB keeps idx + 1 in the table.
+    if (quadrant & 1) {
+        pos = (ALEPH_SINE_QUARTER_PHASE - 1) - pos;
+    }
+
+    idx = pos >> SINE_TABLE_FRAC_BITS;
+    frac = (pos & SINE_TABLE_FRAC_MASK) << (31 - SINE_TABLE_FRAC_BITS);
+
+    ret = add_fr1x32(
+        s_sine_table[idx],
+        mult_fr1x32x32(sub_fr1x32(s_sine_table[idx + 1], s_sine_table[idx]),
+                       frac));
+
+    if (quadrant & 2) {
+        ret = negate_fr1x32(ret);
+    }
+
+    return ret;
+}
+
+fract32 cosine_lookup(int32_t phase) {
+    return sine_lookup((int32_t)((uint32_t)phase + ALEPH_SINE_QUARTER_PHASE));
+}
+
+/*----- Static function implementations ------------------------------*/
+
+/*----- End of file --------------------------------------------------*/
@@ -0,0 +1,60 @@
+/*----------------------------------------------------------------------
+
+                     This file is part of Aleph DSP
+
+                https://github.com/bangcorrupt/aleph-dsp
+
+         Aleph DSP is based on monome/aleph and spiricom/LEAF.
+
+                              MIT License
+
+            Aleph dedicated to the public domain by monome.
+
+                LEAF Copyright Jeff Snyder et. al. 2020
+
+                       Copyright bangcorrupt 2024
+
+----------------------------------------------------------------------*/
+
+/**
+ * @file    aleph_sine_table.h
+ *
+ * @brief   Public API for table based sine and cosine.
+ */
+
+#ifndef ALEPH_SINE_TABLE_H
+#define ALEPH_SINE_TABLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*----- Includes -----------------------------------------------------*/
+
+#include "aleph.h"
+
+/*----- Macros -------------------------------------------------------*/
+
+// Quarter wave table size, must be a power of two.
+#define ALEPH_SINE_TABLE_BITS (8)
+#define ALEPH_SINE_TABLE_SIZE (1 << ALEPH_SINE_TABLE_BITS)
+
+// Phase of a quarter cycle, full cycle wraps at 2^32.
+#define ALEPH_SINE_QUARTER_PHASE (0x40000000)
+
+/*----- Typedefs -----------------------------------------------------*/
+
+/*----- Extern variable declarations ---------------------------------*/
+
+/*----- Extern function prototypes -----------------------------------*/
+
+// Phase is int32 wrapping, one cycle per 2^32, as Aleph_Phasor.
+fract32 sine_lookup(int32_t phase);
+fract32 cosine_lookup(int32_t phase);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+/*----- End of file --------------------------------------------------*/
@@ -0,0 +1,263 @@
+/*----------------------------------------------------------------------
+
+                     This file is part of Aleph DSP
+
+                https://github.com/bangcorrupt/aleph-dsp
+
+         Aleph DSP is based on monome/aleph and spiricom/LEAF.
+
+                              MIT License
+
+            Aleph dedicated to the public domain by monome.
+
+                LEAF Copyright Jeff Snyder et. al. 2020
+
+                       Copyright bangcorrupt 2024
+
+----------------------------------------------------------------------*/
+
+/**
+ * @file    aleph_smoother_bank.c
+ *
+ * @brief   Parameter smoother bank.
+ */
+
+/*----- Includes -----------------------------------------------------*/
+
+#include "aleph.h"
+
+#include "aleph_smoother_bank.h"
+
+/*----- Macros -------------------------------------------------------*/
+
+/*----- Typedefs -----------------------------------------------------*/
+
+/*----- Static variable definitions ----------------------------------*/
+
+/*----- Extern variable definitions ----------------------------------*/
+
+/*----- Static function prototypes -----------------------------------*/
+
+static inline bool _step(t_Aleph_SmootherBank *sb, uint8_t index);
+static void _activate(t_Aleph_SmootherBank *sb, uint8_t index);
+static void _deactivate(t_Aleph_SmootherBank *sb, uint8_t index);
+static fract32 _pow_fr32(fract32 x, size_t n);
+
+/*----- Extern function implementations ------------------------------*/
+
+void Aleph_SmootherBank_init(Aleph_SmootherBank *const bank,
+                             uint8_t num_smoothers, t_Aleph *const aleph) {
+
+    Aleph_SmootherBank_init_to_pool(bank, num_smoothers, &aleph->mempool);
+}
+
+void Aleph_SmootherBank_init_to_pool(Aleph_SmootherBank *const bank,
+                                     uint8_t num_smoothers,
+                                     Mempool *const mempool) {
+
+    t_Mempool *mp = *mempool;
+
+    t_Aleph_SmootherBank *sb = *bank =
+        (t_Aleph_SmootherBank *)mpool_alloc(sizeof(t_Aleph_SmootherBank), mp);
+
+    sb->mempool = mp;
+
+    if (num_smoothers > ALEPH_SMOOTHER_BANK_MAX) {
+        num_smoothers = ALEPH_SMOOTHER_BANK_MAX;
+    }
+
+    sb->num_smoothers = num_smoothers;
+    sb->num_active = 0;
+
+    int i;
+    for (i = 0; i < ALEPH_SMOOTHER_BANK_MAX; i++) {
+        sb->is_active[i] = false;
+        sb->target[i] = 0;
+        sb->output[i] = 0;
+        sb->coeff[i] = ALEPH_SMOOTHER_BANK_DEFAULT_COEFF;
+    }
+}
+
+void Aleph_SmootherBank_free(Aleph_SmootherBank *const bank) {
+
+    t_Aleph_SmootherBank *sb = *bank;
+
+    mpool_free((char *)sb, sb->mempool);
+}
+
+void Aleph_SmootherBank_next(Aleph_SmootherBank *const bank) {
+
+    t_Aleph_SmootherBank *sb = *bank;
+
+    uint8_t index;
+
+    int i = 0;
+    while (i < sb->num_active) {
+
+        index = sb->active[i];
+
+        if (_step(sb, index)) {
+            // Last active index is swapped in, so don't advance.
+            _deactivate(sb, index);
+        } else {
+            i++;
+        }
+    }
+}
+
+fract32 Aleph_SmootherBank_get(Aleph_SmootherBank *const bank,
+                               uint8_t index) {
+
+    t_Aleph_SmootherBank *sb = *bank;
+
+    return sb->output[index];
+}
+
+void Aleph_SmootherBank_next_block(Aleph_SmootherBank *const bank,
+                                   uint8_t index, fract32 *output,
+                                   size_t size) {
+
+    t_Aleph_SmootherBank *sb = *bank;
+
+    int i = 0;
+
+    if (sb->is_active[index]) {
+
+        while (i < size) {
+
+            if (_step(sb, index)) {
+                _deactivate(sb, index);
+                break;
+            }
+            output[i++] = sb->output[index];
+        }
+    }
+
+    for (; i < size; i++) {
+        output[i] = sb->output[index];
+    }
+}
+
+void Aleph_SmootherBank_next_ramp(Aleph_SmootherBank *const bank,
+                                  uint8_t index, t_Aleph_Ramp *ramp,
+                                  size_t size) {
+
+    t_Aleph_SmootherBank *sb = *bank;
+
+    fract32 start = sb->output[index];
+    fract32 target = sb->target[index];
+    fract32 difference;
+
+    if (sb->is_active[index]) {
+
+        // output[n] = target + coeff^n * (output[0] - target)
+        difference = mult_fr1x32x32(_pow_fr32(sb->coeff[index], size),
+                                    sub_fr1x32(start, target));
+
+        if (abs_fr1x32(difference) < ALEPH_SMOOTHER_BANK_THRESHOLD) {
+            sb->output[index] = target;
+            _deactivate(sb, index);
+        } else {
+            sb->output[index] = add_fr1x32(target, difference);
+        }
+    }
+
+    Aleph_Ramp_init(ramp, start, sb->output[index], size);
+}
+
+void Aleph_SmootherBank_set_target(Aleph_SmootherBank *const bank,
+                                   uint8_t index, fract32 target) {
+
+    t_Aleph_SmootherBank *sb = *bank;
+
+    sb->target[index] = target;
+
+    if (sb->output[index] != target) {
+        _activate(sb, index);
+    }
+}
+
+void Aleph_SmootherBank_set_output(Aleph_SmootherBank *const bank,
+                                   uint8_t index, fract32 output) {
+
+    t_Aleph_SmootherBank *sb = *bank;
+
+    sb->output[index] = output;
+
+    if (sb->target[index] != output) {
+        _activate(sb, index);
+    } else if (sb->is_active[index]) {
+        _deactivate(sb, index);
+    }
+}
+
+void Aleph_SmootherBank_set_coeff(Aleph_SmootherBank *const bank,
+                                  uint8_t index, fract32 coeff) {
+
+    t_Aleph_SmootherBank *sb = *bank;
+
+    sb->coeff[index] = coeff;
+}
+
+/*----- Static function implementations ------------------------------*/
+
+// As Aleph_LPFOnePole_next(), returns true when target is reached.
+static inline bool _step(t_Aleph_SmootherBank *sb, uint8_t index) {
+
+    fract32 target = sb->target[index];
+    fract32 difference = sub_fr1x32(sb->output[index], target);
+
+    difference = mult_fr1x32x32(sb->coeff[index], difference);
+
+    if (abs_fr1x32(difference) < ALEPH_SMOOTHER_BANK_THRESHOLD) {
+        sb->output[index] = target;
+        return true;
+    }
+
+    sb->output[index] = add_fr1x32(target, difference);
+
+    return false;
+}
+
+static void _activate(t_Aleph_SmootherBank *sb, uint8_t index) {
+
+    if (!sb->is_active[index]) {
+        sb->active[sb->num_active++] = index;
+        sb->is_active[index] = true;
+    }
+}
+
+// Swap with the last entry, order of the active list is irrelevant.
+static void _deactivate(t_Aleph_SmootherBank *sb, uint8_t index) {
+
+    int i;
+    for (i = 0; i < sb->num_active; i++) {
+
+        if (sb->active[i] == index) {
+            sb->active[i] = sb->active[--sb->num_active];
+            break;
+        }
+    }
+
+    sb->is_active[index] = false;
+}
+
+// Exponentiation by squaring, log2(n) multiplies.
+static fract32 _pow_fr32(fract32 x, size_t n) {
+
+    fract32 result = FR32_MAX;
+
+    while (n > 0) {
+
+        if (n & 1) {
+            result = mult_fr1x32x32(result, x);
+        }
+
+        x = mult_fr1x32x32(x, x);
+        n >>= 1;
+    }
+
+    return result;
+}
+
+/*----- End of file --------------------------------------------------*/
@@ -0,0 +1,106 @@
+/*----------------------------------------------------------------------
+
+                     This file is part of Aleph DSP
+
+                https://github.com/bangcorrupt/aleph-dsp
+
+         Aleph DSP is based on monome/aleph and spiricom/LEAF.
+
+                              MIT License
+
+            Aleph dedicated to the public domain by monome.
+
+                LEAF Copyright Jeff Snyder et. al. 2020
+
+                       Copyright bangcorrupt 2024
+
+----------------------------------------------------------------------*/
+
+/**
+ * @file    aleph_smoother_bank.h
+ *
+ * @brief   Public API for parameter smoother bank.
+ *
+ *          One pole smoothers in contiguous arrays, only those still
+ *          moving toward their target are processed.
+ */
+
+#ifndef ALEPH_SMOOTHER_BANK_H
+#define ALEPH_SMOOTHER_BANK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*----- Includes -----------------------------------------------------*/
+
+#include "aleph.h"
+
+#include "aleph_interpolate.h"
+
+/*----- Macros -------------------------------------------------------*/
+
+#define ALEPH_SMOOTHER_BANK_MAX (16)
+
+#define ALEPH_SMOOTHER_BANK_DEFAULT_COEFF (SLEW_100MS)
+
+// Snap to target when closer than this, a little under -120db.
+#define ALEPH_SMOOTHER_BANK_THRESHOLD (0x4000)
+
+/*----- Typedefs -----------------------------------------------------*/
+
+typedef struct {
+    Mempool mempool;
+    uint8_t num_smoothers;
+    uint8_t num_active;
+    uint8_t active[ALEPH_SMOOTHER_BANK_MAX]; // indices still converging
+    bool is_active[ALEPH_SMOOTHER_BANK_MAX];
+    fract32 target[ALEPH_SMOOTHER_BANK_MAX];
+    fract32 output[ALEPH_SMOOTHER_BANK_MAX];
+    fract32 coeff[ALEPH_SMOOTHER_BANK_MAX];
+} t_Aleph_SmootherBank;
+
+typedef t_Aleph_SmootherBank *Aleph_SmootherBank;
+
+/*----- Extern variable declarations ---------------------------------*/
+
+/*----- Extern function prototypes -----------------------------------*/
+
+void Aleph_SmootherBank_init(Aleph_SmootherBank *const bank,
+                             uint8_t num_smoothers, t_Aleph *const aleph);
+void Aleph_SmootherBank_init_to_pool(Aleph_SmootherBank *const bank,
+                                     uint8_t num_smoothers,
+                                     Mempool *const mempool);
+void Aleph_SmootherBank_free(Aleph_SmootherBank *const bank);
+
+// Advance every active smoother by one sample.
+void Aleph_SmootherBank_next(Aleph_SmootherBank *const bank);
+
+fract32 Aleph_SmootherBank_get(Aleph_SmootherBank *const bank,
+                               uint8_t index);
+
+// Advance one smoother by a block, constant fill once converged.
+// Use instead of Aleph_SmootherBank_next(), not as well as.
+void Aleph_SmootherBank_next_block(Aleph_SmootherBank *const bank,
+                                   uint8_t index, fract32 *output,
+                                   size_t size);
+
+// Advance one smoother by a block, as a linear ramp to the value the one
+// pole would reach after size samples.
+void Aleph_SmootherBank_next_ramp(Aleph_SmootherBank *const bank,
+                                  uint8_t index, t_Aleph_Ramp *ramp,
+                                  size_t size);
+
+void Aleph_SmootherBank_set_target(Aleph_SmootherBank *const bank,
+                                   uint8_t index, fract32 target);
+void Aleph_SmootherBank_set_output(Aleph_SmootherBank *const bank,
+                                   uint8_t index, fract32 output);
+void Aleph_SmootherBank_set_coeff(Aleph_SmootherBank *const bank,
+                                  uint8_t index, fract32 coeff);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+/*----- End of file --------------------------------------------------*/
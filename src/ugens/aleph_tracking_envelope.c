@@ -30,6 +30,7 @@
 
 #include "aleph_interpolate.h"
 #include "aleph_tracking_envelope.h"
+#include "aleph_utils.h"
 
 /*----- Macros -------------------------------------------------------*/
 
@@ -41,6 +42,9 @@
 
 /*----- Static function prototypes -----------------------------------*/
 
+static inline void _rms_push(t_Aleph_TrackingEnvRMS *env, fract32 in);
+static inline fract32 _rms_update(t_Aleph_TrackingEnvRMS *env);
+
 /*----- Extern function implementations ------------------------------*/
 
 void Aleph_TrackingEnvLin_init(t_Aleph_TrackingEnvLin *env) {
@@ -57,6 +61,32 @@ fract32 Aleph_TrackingEnvLin_next(t_Aleph_TrackingEnvLin *env, fract32 in) {
     return env->val;
 }
 
+void Aleph_TrackingEnvLin_next_block(t_Aleph_TrackingEnvLin *env,
+                                     fract32 *input, fract32 *output,
+                                     size_t size) {
+
+    fract32 val = env->val;
+    fract32 up = env->slew.up;
+    fract32 down = env->slew.down;
+    fract32 target;
+
+    int i;
+    for (i = 0; i < size; i++) {
+
+        target = abs_fr1x32(input[i]);
+
+        if (val > target) {
+            val -= min_fr1x32(val - target, down);
+        } else if (val < target) {
+            val += min_fr1x32(target - val, up);
+        }
+
+        output[i] = val;
+    }
+
+    env->val = val;
+}
+
 void Aleph_TrackingEnvLog_init(t_Aleph_TrackingEnvLog *env) {
 
     env->val = 0;
@@ -79,6 +109,154 @@ fract32 Aleph_TrackingEnvLog_next(t_Aleph_TrackingEnvLog *env, fract32 in) {
     return env->val;
 }
 
+bool Aleph_TrackingEnvLog_next_block(t_Aleph_TrackingEnvLog *env,
+                                     fract32 *input, fract32 *output,
+                                     size_t size) {
+
+    fract32 val = env->val;
+    fract32 up = sub_fr1x32(FR32_MAX, env->up);
+    fract32 down = sub_fr1x32(FR32_MAX, env->down);
+    fract32 peak = val;
+    fract32 target;
+
+    int i;
+    for (i = 0; i < size; i++) {
+
+        target = abs_fr1x32(input[i]);
+
+        if (target > val) {
+            val = add_fr1x32(target, mult_fr1x32x32(up, val - target));
+            peak = max_fr1x32(peak, val);
+
+        } else if (target < val) {
+            val = add_fr1x32(target, mult_fr1x32x32(down, val - target));
+        }
+
+        output[i] = val;
+    }
+
+    env->val = val;
+
+    return peak >= env->gate;
+}
+
+void Aleph_TrackingEnvRMS_init(Aleph_TrackingEnvRMS *const env,
+                               uint32_t max_window, t_Aleph *const aleph) {
+
+    Aleph_TrackingEnvRMS_init_to_pool(env, max_window, &aleph->mempool);
+}
+
+void Aleph_TrackingEnvRMS_init_to_pool(Aleph_TrackingEnvRMS *const env,
+                                       uint32_t max_window,
+                                       Mempool *const mempool) {
+
+    t_Mempool *mp = *mempool;
+
+    t_Aleph_TrackingEnvRMS *ev = *env = (t_Aleph_TrackingEnvRMS *)mpool_alloc(
+        sizeof(t_Aleph_TrackingEnvRMS), mp);
+
+    ev->mempool = mp;
+
+    ev->squares = (fract32 *)mpool_calloc(sizeof(fract32) * max_window, mp);
+
+    ev->max_window = max_window;
+    ev->window = max_window;
+    ev->index = 0;
+    ev->sum = 0;
+    ev->rms = 0;
+}
+
+void Aleph_TrackingEnvRMS_free(Aleph_TrackingEnvRMS *const env) {
+
+    t_Aleph_TrackingEnvRMS *ev = *env;
+
+    mpool_free((char *)ev->squares, ev->mempool);
+    mpool_free((char *)ev, ev->mempool);
+}
+
+void Aleph_TrackingEnvRMS_reset(Aleph_TrackingEnvRMS *const env) {
+
+    t_Aleph_TrackingEnvRMS *ev = *env;
+
+    int i;
+    for (i = 0; i < ev->window; i++) {
+        ev->squares[i] = 0;
+    }
+
+    ev->index = 0;
+    ev->sum = 0;
+    ev->rms = 0;
+}
+
+void Aleph_TrackingEnvRMS_set_window(Aleph_TrackingEnvRMS *const env,
+                                     uint32_t window) {
+
+    t_Aleph_TrackingEnvRMS *ev = *env;
+
+    if (window < 1) {
+        window = 1;
+    } else if (window > ev->max_window) {
+        window = ev->max_window;
+    }
+
+    ev->window = window;
+
+    Aleph_TrackingEnvRMS_reset(env);
+}
+
+fract32 Aleph_TrackingEnvRMS_next(Aleph_TrackingEnvRMS *const env,
+                                  fract32 in) {
+
+    t_Aleph_TrackingEnvRMS *ev = *env;
+
+    _rms_push(ev, in);
+
+    return _rms_update(ev);
+}
+
+fract32 Aleph_TrackingEnvRMS_next_block(Aleph_TrackingEnvRMS *const env,
+                                        fract32 *input, size_t size) {
+
+    t_Aleph_TrackingEnvRMS *ev = *env;
+
+    int i;
+    for (i = 0; i < size; i++) {
+        _rms_push(ev, input[i]);
+    }
+
+    return _rms_update(ev);
+}
+
+fract32 Aleph_TrackingEnvRMS_get(Aleph_TrackingEnvRMS *const env) {
+
+    t_Aleph_TrackingEnvRMS *ev = *env;
+
+    return ev->rms;
+}
+
 /*----- Static function implementations ------------------------------*/
 
+// Integer sum is exact, so removing old squares never drifts.
+static inline void _rms_push(t_Aleph_TrackingEnvRMS *env, fract32 in) {
+
+    fract32 square = mult_fr1x32x32(in, in);
+
+    env->sum += square - env->squares[env->index];
+    env->squares[env->index] = square;
+
+    if (++env->index >= env->window) {
+        env->index = 0;
+    }
+}
+
+static inline fract32 _rms_update(t_Aleph_TrackingEnvRMS *env) {
+
+    uint64_t mean = (uint64_t)(env->sum / env->window);
+
+    // sqrt(mean / 2^31) * 2^31
+    env->rms = (fract32)isqrt_64(mean << 31);
+
+    return env->rms;
+}
+
 /*----- End of file --------------------------------------------------*/
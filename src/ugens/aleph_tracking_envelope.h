@@ -55,16 +55,59 @@ typedef struct {
 
 } t_Aleph_TrackingEnvLog;
 
+// Mean square over a sliding window, running sum of squares.
+typedef struct {
+    Mempool mempool;
+    fract32 *squares;
+    uint32_t max_window;
+    uint32_t window;
+    uint32_t index;
+    int64_t sum;
+    fract32 rms;
+} t_Aleph_TrackingEnvRMS;
+
+typedef t_Aleph_TrackingEnvRMS *Aleph_TrackingEnvRMS;
+
 /*----- Extern variable declarations ---------------------------------*/
 
 /*----- Extern function prototypes -----------------------------------*/
 
 void Aleph_TrackingEnvLin_init(t_Aleph_TrackingEnvLin *env);
 fract32 Aleph_TrackingEnvLin_next(t_Aleph_TrackingEnvLin *env, fract32 in);
+void Aleph_TrackingEnvLin_next_block(t_Aleph_TrackingEnvLin *env,
+                                     fract32 *input, fract32 *output,
+                                     size_t size);
 
 void Aleph_TrackingEnvLog_init(t_Aleph_TrackingEnvLog *env);
 fract32 Aleph_TrackingEnvLog_next(t_Aleph_TrackingEnvLog *env, fract32 in);
 
+// Returns false if the envelope stayed below gate for the whole block.
+bool Aleph_TrackingEnvLog_next_block(t_Aleph_TrackingEnvLog *env,
+                                     fract32 *input, fract32 *output,
+                                     size_t size);
+
+void Aleph_TrackingEnvRMS_init(Aleph_TrackingEnvRMS *const env,
+                               uint32_t max_window, t_Aleph *const aleph);
+void Aleph_TrackingEnvRMS_init_to_pool(Aleph_TrackingEnvRMS *const env,
+                                       uint32_t max_window,
+                                       Mempool *const mempool);
+void Aleph_TrackingEnvRMS_free(Aleph_TrackingEnvRMS *const env);
+
+void Aleph_TrackingEnvRMS_reset(Aleph_TrackingEnvRMS *const env);
+
+// Window in samples, clears history.
+void Aleph_TrackingEnvRMS_set_window(Aleph_TrackingEnvRMS *const env,
+                                     uint32_t window);
+
+fract32 Aleph_TrackingEnvRMS_next(Aleph_TrackingEnvRMS *const env,
+                                  fract32 in);
+
+// Returns RMS at the end of the block, one square root per block.
+fract32 Aleph_TrackingEnvRMS_next_block(Aleph_TrackingEnvRMS *const env,
+                                        fract32 *input, size_t size);
+
+fract32 Aleph_TrackingEnvRMS_get(Aleph_TrackingEnvRMS *const env);
+
 #ifdef __cplusplus
 }
 #endif
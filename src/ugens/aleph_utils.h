@@ -78,6 +78,38 @@ static inline fract32 freq_to_phase(fix16 freq) {
     return shr_fr1x32(ret, rad - 1);
 }
 
+// Integer square root, rounds down.
+static inline uint32_t isqrt_64(uint64_t x) {
+    uint64_t root = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+
+    while (bit > x) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (x >= root + bit) {
+            x -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+// Saturate a 64-bit accumulator to fract32.
+static inline fract32 sat_fr32(int64_t acc) {
+
+    if (acc > FR32_MAX) {
+        return FR32_MAX;
+    } else if (acc < FR32_MIN) {
+        return FR32_MIN;
+    } else {
+        return (fract32)acc;
+    }
+}
+
 #ifdef __cplusplus
 }
 #endif
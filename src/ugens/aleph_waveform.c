@@ -151,6 +151,8 @@ void Aleph_WaveformDual_init_to_pool(Aleph_WaveformDual *const wave,
     wv->shape_a = WAVEFORM_SHAPE_SINE;
     wv->shape_b = WAVEFORM_SHAPE_SINE;
 
+    wv->dc_block = NULL;
+
     Aleph_Phasor_init_to_pool(&wv->phasor_a, mempool);
     Aleph_Phasor_set_freq(&wv->phasor_a, WAVEFORM_DEFAULT_FREQ);
     Aleph_Phasor_set_phase(&wv->phasor_a, WAVEFORM_DEFAULT_PHASE);
@@ -229,6 +231,18 @@ fract32 Aleph_WaveformDual_next(Aleph_WaveformDual *const wave) {
     return add_fr1x32(shl_fr1x32(next_a, 15), shl_fr1x32(next_b, 15));
 }
 
+void Aleph_WaveformDual_set_dc_block(Aleph_WaveformDual *const wave,
+                                     Aleph_HPF *const dc_block) {
+
+    t_Aleph_WaveformDual *wv = *wave;
+
+    if (dc_block != NULL) {
+        wv->dc_block = *dc_block;
+    } else {
+        wv->dc_block = NULL;
+    }
+}
+
 void Aleph_WaveformDual_next_block(Aleph_WaveformDual *const wave,
                                    fract32 *output, size_t size) {
 
@@ -290,11 +304,17 @@ void Aleph_WaveformDual_next_block(Aleph_WaveformDual *const wave,
         break;
     }
 
+    t_Aleph_HPF *dc_block = wv->dc_block;
+
     int i;
     for (i = 0; i < size; i++) {
 
         output[i] =
             add_fr1x32(shl_fr1x32(next_a[i], 15), shl_fr1x32(next_b[i], 15));
+
+        if (dc_block != NULL) {
+            output[i] = _dc_block_calc(dc_block, output[i]);
+        }
     }
 
     mpool_free((char *)next_a, wv->mempool);
@@ -369,17 +389,98 @@ void Aleph_WaveformDual_next_block_smooth(Aleph_WaveformDual *const wave,
         break;
     }
 
+    t_Aleph_HPF *dc_block = wv->dc_block;
+
     int i;
     for (i = 0; i < size; i++) {
 
         output[i] =
             add_fr1x32(shl_fr1x32(next_a[i], 15), shl_fr1x32(next_b[i], 15));
+
+        if (dc_block != NULL) {
+            output[i] = _dc_block_calc(dc_block, output[i]);
+        }
     }
 
     mpool_free((char *)next_a, wv->mempool);
     mpool_free((char *)next_b, wv->mempool);
 }
 
+void Aleph_WaveformDual_next_block_ramp_split(Aleph_WaveformDual *const wave,
+                                              t_Aleph_Ramp *freq_a,
+                                              t_Aleph_Ramp *freq_b,
+                                              fract32 *scratch,
+                                              fract32 *output, size_t size) {
+
+    t_Aleph_WaveformDual *wv = *wave;
+
+    // Output doubles as phase and polyblep buffer for oscillator A.
+    fract32 *next_a = output;
+    fract32 *next_b = scratch;
+
+    Aleph_Phasor_next_block_ramp(&wv->phasor_a, freq_a, next_a, size);
+    Aleph_Phasor_next_block_ramp(&wv->phasor_b, freq_b, next_b, size);
+
+    switch (wv->shape_a) {
+
+    case WAVEFORM_SHAPE_SINE:
+        sine_polyblep_block(next_a, next_a, size);
+        break;
+
+    case WAVEFORM_SHAPE_TRIANGLE:
+        triangle_polyblep_block(next_a, next_a, size);
+        break;
+
+    case WAVEFORM_SHAPE_SAW:
+        saw_polyblep_block_ramp(next_a, freq_a, next_a, size);
+        break;
+
+    case WAVEFORM_SHAPE_SQUARE:
+        square_polyblep_block_ramp(next_a, freq_a, next_a, size);
+        break;
+
+    default:
+        sine_polyblep_block(next_a, next_a, size);
+        break;
+    }
+
+    switch (wv->shape_b) {
+
+    case WAVEFORM_SHAPE_SINE:
+        sine_polyblep_block(next_b, next_b, size);
+        break;
+
+    case WAVEFORM_SHAPE_TRIANGLE:
+        triangle_polyblep_block(next_b, next_b, size);
+        break;
+
+    case WAVEFORM_SHAPE_SAW:
+        saw_polyblep_block_ramp(next_b, freq_b, next_b, size);
+        break;
+
+    case WAVEFORM_SHAPE_SQUARE:
+        square_polyblep_block_ramp(next_b, freq_b, next_b, size);
+        break;
+
+    default:
+        sine_polyblep_block(next_b, next_b, size);
+        break;
+    }
+
+    t_Aleph_HPF *dc_block = wv->dc_block;
+
+    int i;
+    for (i = 0; i < size; i++) {
+
+        output[i] =
+            add_fr1x32(shl_fr1x32(next_a[i], 15), shl_fr1x32(next_b[i], 15));
+
+        if (dc_block != NULL) {
+            output[i] = _dc_block_calc(dc_block, output[i]);
+        }
+    }
+}
+
 void Aleph_WaveformDual_set_shape(Aleph_WaveformDual *const wave,
                                   e_Aleph_Waveform_shape shape) {
 
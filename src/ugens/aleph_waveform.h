@@ -33,6 +33,8 @@ extern "C" {
 
 #include "aleph.h"
 
+#include "aleph_filter.h"
+#include "aleph_interpolate.h"
 #include "aleph_phasor.h"
 
 /*----- Macros -------------------------------------------------------*/
@@ -63,6 +65,7 @@ typedef struct {
     Aleph_Phasor phasor_b;
     uint8_t shape_a;
     uint8_t shape_b;
+    t_Aleph_HPF *dc_block; // Optional, applied by block kernels.
 } t_Aleph_WaveformDual;
 
 typedef t_Aleph_WaveformDual *Aleph_WaveformDual;
@@ -116,6 +119,10 @@ void Aleph_WaveformDual_set_phase_a(Aleph_WaveformDual *const wave,
 void Aleph_WaveformDual_set_phase_b(Aleph_WaveformDual *const wave,
                                     int32_t phase);
 
+// Block kernels apply `dc_block` to their output, NULL disables.
+void Aleph_WaveformDual_set_dc_block(Aleph_WaveformDual *const wave,
+                                     Aleph_HPF *const dc_block);
+
 void Aleph_WaveformDual_next_block(Aleph_WaveformDual *const wave,
                                    fract32 *output, size_t size);
 
@@ -123,6 +130,13 @@ void Aleph_WaveformDual_next_block_smooth(Aleph_WaveformDual *const wave,
                                           fract32 *freq, fract32 *output,
                                           size_t size);
 
+// Separate ramps for oscillators A and B, `scratch` holds `size` samples.
+void Aleph_WaveformDual_next_block_ramp_split(Aleph_WaveformDual *const wave,
+                                              t_Aleph_Ramp *freq_a,
+                                              t_Aleph_Ramp *freq_b,
+                                              fract32 *scratch,
+                                              fract32 *output, size_t size);
+
 /*----- Extern function prototypes -----------------------------------*/
 
 #ifdef __cplusplus
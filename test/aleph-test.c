@@ -20,30 +20,279 @@
  * @file    aleph_test.c
  *
  * @brief   Tests for Aleph DSP.
+ *
+ *          Runs on host or target, returns the number of failed checks.
  */
 
 /*----- Includes -----------------------------------------------------*/
 
+#include <math.h>
+#include <stdio.h>
+
 #include "aleph.h"
 
+#include "aleph_fft.h"
+
 /*----- Macros -------------------------------------------------------*/
 
+#define TEST_MEMORY_SIZE (0x10000)
+
+#define TEST_FFT_LOG2_SIZE (8)
+#define TEST_FFT_SIZE (1 << TEST_FFT_LOG2_SIZE)
+
+// Each trial uses a different noise seed and sine phase.
+#define TEST_FFT_TRIALS (8)
+
+// Error relative to the largest reference bin.
+#define TEST_FFT_TOLERANCE_32 (1e-6)
+#define TEST_FFT_TOLERANCE_16 (4e-3)
+
 /*----- Typedefs -----------------------------------------------------*/
 
+typedef enum {
+    TEST_SIGNAL_NOISE_FULL,
+    TEST_SIGNAL_NOISE_HALF,
+    TEST_SIGNAL_SINE_FULL,
+    TEST_NUM_SIGNALS,
+} e_Test_signal;
+
 /*----- Static variable definitions ----------------------------------*/
 
+static char _memory[TEST_MEMORY_SIZE];
+
+static fract32 _data[2 * TEST_FFT_SIZE];
+static fract16 _data_16[2 * TEST_FFT_SIZE];
+static double _input[2 * TEST_FFT_SIZE];
+static double _reference[2 * TEST_FFT_SIZE + 2];
+
 /*----- Extern variable definitions ----------------------------------*/
 
 /*----- Static function prototypes -----------------------------------*/
 
+static int _test_fft(t_Aleph *aleph);
+static int _test_fft_signal(Aleph_FFT *fft, e_Test_signal signal,
+                            int trial);
+static void _signal(e_Test_signal signal, int trial, int count);
+static void _dft(int count, bool real);
+static double _error(double *output, int bins);
+static int _check(const char *name, e_Test_signal signal, int trial,
+                  double error, double tolerance);
+
 /*----- Extern function implementations ------------------------------*/
 
 int main(void) {
 
-    //
-    return 0;
+    t_Aleph aleph;
+
+    Aleph_init(&aleph, 48000, _memory, TEST_MEMORY_SIZE, NULL);
+
+    return _test_fft(&aleph);
 }
 
 /*----- Static function implementations ------------------------------*/
 
+// Compare each transform against a double precision DFT of the same
+// input. Full scale noise exercises the block floating point headroom.
+static int _test_fft(t_Aleph *aleph) {
+
+    Aleph_FFT fft;
+
+    int failures = 0;
+    int signal, trial;
+
+    Aleph_FFT_init(&fft, TEST_FFT_LOG2_SIZE, aleph);
+
+    for (signal = 0; signal < TEST_NUM_SIGNALS; signal++) {
+        for (trial = 0; trial < TEST_FFT_TRIALS; trial++) {
+            failures += _test_fft_signal(&fft, signal, trial);
+        }
+    }
+
+    Aleph_FFT_free(&fft);
+
+    return failures;
+}
+
+static int _test_fft_signal(Aleph_FFT *fft, e_Test_signal signal,
+                            int trial) {
+
+    int n = TEST_FFT_SIZE;
+    int failures = 0;
+    int exponent, exponent_inverse;
+    double out[2 * TEST_FFT_SIZE + 2];
+    double scale;
+    int i;
+
+    // Complex fract32, forward then round trip.
+    _signal(signal, trial, 2 * n);
+    _dft(n, false);
+
+    for (i = 0; i < 2 * n; i++) {
+        _data[i] = (fract32)ldexp(_input[i], 31);
+    }
+
+    exponent = Aleph_FFT_complex_forward(fft, _data);
+
+    for (i = 0; i < 2 * n; i++) {
+        out[i] = ldexp(_data[i], exponent - 31);
+    }
+
+    failures += _check("complex forward", signal, trial, _error(out, n),
+                       TEST_FFT_TOLERANCE_32);
+
+    exponent_inverse = Aleph_FFT_complex_inverse(fft, _data);
+    scale = ldexp(1.0, exponent + exponent_inverse - 31) / n;
+
+    for (i = 0; i < 2 * n; i++) {
+        _reference[i] = _input[i];
+        out[i] = _data[i] * scale;
+    }
+
+    failures += _check("complex round trip", signal, trial, _error(out, n),
+                       TEST_FFT_TOLERANCE_32);
+
+    // Complex fract16.
+    _dft(n, false);
+
+    for (i = 0; i < 2 * n; i++) {
+        _data_16[i] = (fract16)ldexp(_input[i], 15);
+    }
+
+    exponent = Aleph_FFT_complex_forward_16(fft, _data_16);
+
+    for (i = 0; i < 2 * n; i++) {
+        out[i] = ldexp(_data_16[i], exponent - 15);
+    }
+
+    failures += _check("complex forward 16", signal, trial, _error(out, n),
+                       TEST_FFT_TOLERANCE_16);
+
+    // Real fract32, 2 * size samples, forward then round trip.
+    _dft(2 * n, true);
+
+    for (i = 0; i < 2 * n; i++) {
+        _data[i] = (fract32)ldexp(_input[i], 31);
+    }
+
+    exponent = Aleph_FFT_real_forward(fft, _data);
+
+    // Unpack DC and Nyquist to match the reference bins.
+    out[0] = ldexp(_data[0], exponent - 31);
+    out[1] = 0;
+    out[2 * n] = ldexp(_data[1], exponent - 31);
+    out[2 * n + 1] = 0;
+
+    for (i = 2; i < 2 * n; i++) {
+        out[i] = ldexp(_data[i], exponent - 31);
+    }
+
+    failures += _check("real forward", signal, trial, _error(out, n + 1),
+                       TEST_FFT_TOLERANCE_32);
+
+    exponent_inverse = Aleph_FFT_real_inverse(fft, _data);
+    scale = ldexp(1.0, exponent + exponent_inverse - 31) / n;
+
+    for (i = 0; i < 2 * n; i++) {
+        _reference[i] = _input[i];
+        out[i] = _data[i] * scale;
+    }
+
+    failures += _check("real round trip", signal, trial, _error(out, n),
+                       TEST_FFT_TOLERANCE_32);
+
+    return failures;
+}
+
+// Fill _input with count values in [-1, 1).
+static void _signal(e_Test_signal signal, int trial, int count) {
+
+    uint32_t seed = trial + 1;
+    double amplitude;
+
+    int i;
+    for (i = 0; i < count; i++) {
+
+        seed = seed * 1664525 + 1013904223;
+
+        switch (signal) {
+
+        case TEST_SIGNAL_NOISE_FULL:
+        case TEST_SIGNAL_NOISE_HALF:
+            // Binary noise, the worst case for butterfly growth.
+            amplitude = signal == TEST_SIGNAL_NOISE_FULL ? 1.0 : 0.5;
+            _input[i] = seed & 0x80000000 ? -amplitude : amplitude;
+            break;
+
+        default:
+            _input[i] = sin(0.3 * i + trial);
+            break;
+        }
+
+        // Largest representable positive value.
+        if (_input[i] >= 1.0) {
+            _input[i] = 1.0 - ldexp(1.0, -31);
+        }
+    }
+}
+
+// Reference transform of _input into _reference. Complex input holds
+// count interleaved points, real input holds count samples and gives
+// count / 2 + 1 bins.
+static void _dft(int count, bool real) {
+
+    int bins = real ? count / 2 + 1 : count;
+    double re, im, x_re, x_im, phase;
+
+    int k, i;
+    for (k = 0; k < bins; k++) {
+
+        re = 0;
+        im = 0;
+
+        for (i = 0; i < count; i++) {
+
+            x_re = real ? _input[i] : _input[2 * i];
+            x_im = real ? 0 : _input[2 * i + 1];
+            phase = -2 * M_PI * (double)k * i / count;
+
+            re += x_re * cos(phase) - x_im * sin(phase);
+            im += x_re * sin(phase) + x_im * cos(phase);
+        }
+
+        _reference[2 * k] = re;
+        _reference[2 * k + 1] = im;
+    }
+}
+
+// Largest bin error relative to the largest reference bin.
+static double _error(double *output, int bins) {
+
+    double error = 0;
+    double peak = 0;
+
+    int k;
+    for (k = 0; k < bins; k++) {
+
+        error = fmax(error, hypot(output[2 * k] - _reference[2 * k],
+                                  output[2 * k + 1] - _reference[2 * k + 1]));
+
+        peak = fmax(peak, hypot(_reference[2 * k], _reference[2 * k + 1]));
+    }
+
+    return error / peak;
+}
+
+static int _check(const char *name, e_Test_signal signal, int trial,
+                  double error, double tolerance) {
+
+    if (error < tolerance) {
+        return 0;
+    }
+
+    printf("FAIL fft %s, signal %d, trial %d, error %g\n", name, signal,
+           trial, error);
+
+    return 1;
+}
+
 /*----- End of file --------------------------------------------------*/